@@ -0,0 +1,158 @@
+/*!
+ *   Compile-time specialized MPL3115A2 driver for deployments that fix the mode and the
+ *   oversampling ratio at build time.
+ *
+ *      MPL3115A2T<MPL_MODE_BAROMETER, 16> MPL(p9, p10);
+ *
+ *   CTRL_REG1, the conversion time and the decoder are resolved by the compiler: a trigger is a
+ *   single write of a constant (no shadow copy, no read-modify-write), the core sleeps for a fixed
+ *   conversion time (MPL3115A2_Sleep.h) and only the decoder of the selected mode is instantiated. An invalid OSR does not
+ *   compile. Header only, C++98 (enums instead of constexpr) for the mbed online compiler.
+ *
+ *   Values are returned in the fixed-point formats of MPL3115A2_Decode.h. Use MPL3115A2 (MPL3115A2_IO.h)
+ *   when the mode, FIFO, interrupts or the alarm registers must be changed at runtime.
+ *
+*/
+
+#include "mbed.h"
+#ifndef MPL3115A2T_H_
+#define MPL3115A2T_H_
+
+#include "MPL3115A2_REGISTER_MAP.h"
+#include "MPL3115A2_Decode.h"
+#include "MPL3115A2_Sleep.h"
+
+#define MPL_MODE_BAROMETER 0   // Pressure in Q18.2 Pa
+#define MPL_MODE_ALTIMETER 1   // Altitude in Q16.4 m
+
+template <int OSR> struct MPL_OSR_Traits;   // Only the ratios below are defined: any other OSR fails to compile.
+
+template <> struct MPL_OSR_Traits<1>   { enum { Bits = 0x00,             Conversion_Time_us = MPL_CONVERSION_TIME_OS1_US   }; };   // OS[5:3] = 000
+template <> struct MPL_OSR_Traits<2>   { enum { Bits = CTRL_REG1_OS_2,   Conversion_Time_us = MPL_CONVERSION_TIME_OS2_US   }; };
+template <> struct MPL_OSR_Traits<4>   { enum { Bits = CTRL_REG1_OS_4,   Conversion_Time_us = MPL_CONVERSION_TIME_OS4_US   }; };
+template <> struct MPL_OSR_Traits<8>   { enum { Bits = CTRL_REG1_OS_8,   Conversion_Time_us = MPL_CONVERSION_TIME_OS8_US   }; };
+template <> struct MPL_OSR_Traits<16>  { enum { Bits = CTRL_REG1_OS_16,  Conversion_Time_us = MPL_CONVERSION_TIME_OS16_US  }; };
+template <> struct MPL_OSR_Traits<32>  { enum { Bits = CTRL_REG1_OS_32,  Conversion_Time_us = MPL_CONVERSION_TIME_OS32_US  }; };
+template <> struct MPL_OSR_Traits<64>  { enum { Bits = CTRL_REG1_OS_64,  Conversion_Time_us = MPL_CONVERSION_TIME_OS64_US  }; };
+template <> struct MPL_OSR_Traits<128> { enum { Bits = CTRL_REG1_OS_128, Conversion_Time_us = MPL_CONVERSION_TIME_OS128_US }; };
+
+template <int Mode> struct MPL_Mode_Traits;   // MPL_MODE_BAROMETER or MPL_MODE_ALTIMETER only.
+
+template <> struct MPL_Mode_Traits<MPL_MODE_BAROMETER>
+{
+    enum { Bits = 0 };
+    static inline int32_t Decode(const char *Raw) { return MPL_Decode_Pressure(Raw); }
+};
+
+template <> struct MPL_Mode_Traits<MPL_MODE_ALTIMETER>
+{
+    enum { Bits = CTRL_REG1_ALT };
+    static inline int32_t Decode(const char *Raw) { return MPL_Decode_Altitude(Raw); }
+};
+
+template <int Mode, int OSR>
+class MPL3115A2T
+{
+
+public:
+
+    enum
+    {
+        CTRL_REG1_Value    = MPL_Mode_Traits<Mode>::Bits | MPL_OSR_Traits<OSR>::Bits,   // STANDBY, selected mode and ratio
+        Conversion_Time_us = MPL_OSR_Traits<OSR>::Conversion_Time_us
+    };
+
+    MPL3115A2T(PinName sda, PinName scl) : _i2c(sda, scl)
+    {
+        _i2c.frequency(400000);
+    }
+
+    bool MPL_Init()  // Write the fixed configuration to CTRL_REG1. Returns 'false' if the device does not acknowledge.
+    {
+        char temp[2] = {CTRL_REG1, (char)CTRL_REG1_Value};
+
+        return (_i2c.write(MPL3115A2_WRITE, temp, 2) == 0);
+    }
+
+    void MPL_One_Shot_Measure()  // Single write of a constant. MPL_Init() must have been called once.
+    {
+        char temp[2] = {CTRL_REG1, (char)(CTRL_REG1_Value | CTRL_REG1_OST)};
+
+        _i2c.write(MPL3115A2_WRITE, temp, 2);
+    }
+
+    bool MPL_Wait_For_Conversion()  // Nominal conversion time, then one OST check. Returns 'false' after MPL_CONVERSION_TIMEOUT conversion times without completion.
+    {
+        char temp[1];
+        Timer Elapsed;
+
+        Elapsed.start();
+        Sleeper.Sleep(NULL, Conversion_Time_us);
+
+        while (true)
+        {
+            temp[0] = CTRL_REG1;
+            _i2c.write(MPL3115A2_WRITE, temp, 1, true);
+            _i2c.read(MPL3115A2_READ, temp, 1);
+
+            if ((temp[0] & CTRL_REG1_OST) == 0)
+            {
+                return true;
+            }
+
+            if (Elapsed.read_us() >= MPL_CONVERSION_TIMEOUT * Conversion_Time_us)
+            {
+                return false;
+            }
+
+            Sleeper.Sleep(NULL, MPL_CONVERSION_RETRY_US);
+        }
+    }
+
+    int32_t MPL_Read()  // Pressure (Q18.2 Pa) or Altitude (Q16.4 m), depending on Mode. One trigger, one 3-byte burst. MPL_NO_READING on conversion timeout.
+    {
+        char temp[3];
+
+        MPL_One_Shot_Measure();
+
+        if (MPL_Wait_For_Conversion() == false)
+        {
+            return MPL_NO_READING;   // OUT_P still holds the previous conversion.
+        }
+
+        temp[0] = OUT_P_MSB;
+        _i2c.write(MPL3115A2_WRITE, temp, 1, true);
+        _i2c.read(MPL3115A2_READ, temp, 3);
+
+        return MPL_Mode_Traits<Mode>::Decode(temp);
+    }
+
+    bool MPL_Read_Sample(int32_t &Value, int32_t &Temperature)  // Value as MPL_Read() plus Temperature in Q8.4 C from the same conversion. One 5-byte burst. Returns 'false' on conversion timeout, outputs untouched.
+    {
+        char temp[5];
+
+        MPL_One_Shot_Measure();
+
+        if (MPL_Wait_For_Conversion() == false)
+        {
+            return false;
+        }
+
+        temp[0] = OUT_P_MSB;
+        _i2c.write(MPL3115A2_WRITE, temp, 1, true);
+        _i2c.read(MPL3115A2_READ, temp, 5);   // Auto-increment: OUT_P_MSB, OUT_P_CSB, OUT_P_LSB, OUT_T_MSB, OUT_T_LSB
+
+        Value = MPL_Mode_Traits<Mode>::Decode(&temp[0]);
+        Temperature = MPL_Decode_Temperature(&temp[3]);
+
+        return true;
+    }
+
+private:
+
+    I2C _i2c;
+    MPL_Sleep_Timer Sleeper;
+
+};
+
+#endif
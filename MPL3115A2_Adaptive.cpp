@@ -0,0 +1,231 @@
+#include "MPL3115A2_Adaptive.h"
+
+
+static uint32_t MPL_Adaptive_Sqrt(uint64_t Value)  // Integer square root, rounded down.
+{
+    uint64_t Root = 0;
+    uint64_t Bit = (uint64_t)1 << 62;
+
+    while (Bit > Value){Bit >>= 2;}
+
+    while (Bit != 0)
+    {
+        if (Value >= Root + Bit)
+        {
+            Value -= Root + Bit;
+            Root = (Root >> 1) + Bit;
+        }
+        else
+        {
+            Root >>= 1;
+        }
+
+        Bit >>= 2;
+    }
+
+    return (uint32_t)Root;
+}
+
+
+MPL3115A2_Adaptive_OSR::MPL3115A2_Adaptive_OSR(MPL3115A2 *Sensor, int32_t Noise_Target, int Latency_Budget_us) : Sensor(Sensor)
+{
+    Target_Var_Q8 = (int64_t)Noise_Target * Noise_Target * 256;
+    
+    Max_Index = 0;
+    
+    for (int i = 7; i > 0; i--)   // OSR = 1 is always allowed, even when the budget is shorter than 6 ms.
+    {
+        if (MPL_Conversion_Time_Table_us[i] <= Latency_Budget_us)
+        {
+            Max_Index = i;
+            break;
+        }
+    }
+    
+    OSR_Index = 0;
+    
+    while ((1 << OSR_Index) < Sensor->MPL_Get_Oversampling()){OSR_Index++;}   // Starts from the ratio already set, no write unless the budget forbids it.
+    
+    Noise_Var_Q8 = Target_Var_Q8;   // Neutral until the first changes have been seen.
+    Trend_Rate = 0;
+    Previous_Value = 0;
+    Previous_Time_us = 0;
+    Have_Previous = false;
+    Previous_Bar_Mode = true;
+    Dwell = 0;
+    Switch_Count = 0;
+    
+    if (OSR_Index > Max_Index)
+    {
+        Apply(Max_Index);
+    }
+}
+
+bool MPL3115A2_Adaptive_OSR::Update(const MPL_Sample &Sample)  // The change is taken against the previous sample.
+{
+    int32_t Value = Sample.Bar_Mode ? Sample.Pressure_Fixed : Sample.Altitude_Fixed;
+    bool First = (Have_Previous == false) || (Sample.Bar_Mode != Previous_Bar_Mode);
+    int32_t Delta = Value - Previous_Value;
+    
+    Previous_Value = Value;
+    
+    if (First == true)   // Nothing to compare with yet, or the units changed with the mode: start over.
+    {
+        Update_Delta(0, Sample.Bar_Mode, Sample.Timestamp_us);
+        return false;
+    }
+    
+    return Update_Delta(Delta, Sample.Bar_Mode, Sample.Timestamp_us);
+}
+
+bool MPL3115A2_Adaptive_OSR::Update(const MPL_Frame &Frame)  // The change comes from the delta registers: no previous value needed.
+{
+    return Update_Delta(Frame.Current.Bar_Mode ? Frame.Pressure_Change_Fixed : Frame.Altitude_Change_Fixed, Frame.Current.Bar_Mode, Frame.Current.Timestamp_us);
+}
+
+bool MPL3115A2_Adaptive_OSR::Update_Delta(int32_t Delta, bool Bar_Mode, uint32_t Time_us)  // Statistics update and decision, one call per sample.
+{
+    if ((Have_Previous == false) || (Bar_Mode != Previous_Bar_Mode))
+    {
+        Have_Previous = true;
+        Previous_Bar_Mode = Bar_Mode;
+        Previous_Time_us = Time_us;
+        Noise_Var_Q8 = Target_Var_Q8;
+        Trend_Rate = 0;
+        Dwell = 0;
+        return false;
+    }
+    
+    uint32_t Elapsed_us = Time_us - Previous_Time_us;   // Between the two conversions, not the two reads: polling jitter stays out of the rate. Wraps correctly on the 32-bit ticker.
+    
+    Previous_Time_us = Time_us;
+    
+    if (Elapsed_us == 0)
+    {
+        return false;
+    }
+    
+    // Trend: rate of change in units per second, averaged over MPL_ADAPTIVE_TREND_US of time rather than over a number
+    // of samples, so its noise does not grow when the ratio (and with it the sample period) goes down.
+    int64_t Rate = (int64_t)Delta * 1000000 / Elapsed_us;
+    int64_t Alpha_Q16 = ((int64_t)Elapsed_us << 16) / MPL_ADAPTIVE_TREND_US;
+    
+    if (Rate > 0x7FFFFFFF){Rate = 0x7FFFFFFF;}
+    if (Rate < -0x7FFFFFFF){Rate = -0x7FFFFFFF;}
+    if (Alpha_Q16 > 32768){Alpha_Q16 = 32768;}
+    
+    Trend_Rate += (int32_t)(((Rate - Trend_Rate) * Alpha_Q16) / 65536);
+    
+    // Noise: what the trend does not explain. The change between two independent samples has twice the
+    // variance of one sample, hence the division by 2. Residual in Q4, its square in Q8.
+    int64_t Residual_Q4 = ((int64_t)Delta * 1000000 - (int64_t)Trend_Rate * Elapsed_us) * 16 / 1000000;
+    int64_t Sample_Var_Q8 = (Residual_Q4 * Residual_Q4) / 2;
+    
+    Noise_Var_Q8 += (Sample_Var_Q8 - Noise_Var_Q8) / 16;
+    
+    Dwell++;
+    
+    // Motion: the signal moves by |rate| x conversion time during one acquisition. Once that is more than the noise
+    // target, averaging longer only adds lag: drop straight to the ratio where the movement fits the target again.
+    int64_t Motion = (int64_t)(Trend_Rate < 0 ? -Trend_Rate : Trend_Rate);
+    
+    if ((OSR_Index > 0) && (Dwell >= MPL_ADAPTIVE_MOTION_DWELL) && (2 * Motion_Var_Q8(Motion, OSR_Index, Elapsed_us) > 3 * Target_Var_Q8))
+    {
+        int Index = OSR_Index;
+        
+        while (Index > 0)
+        {
+            Index--;
+            
+            if (Motion_Var_Q8(Motion, Index, Elapsed_us) <= Target_Var_Q8){break;}
+        }
+        
+        Apply(Index);
+        return true;
+    }
+    
+    if (Dwell < MPL_ADAPTIVE_DWELL)
+    {
+        return false;
+    }
+    
+    // Stationary: each doubling of the ratio halves the variance. Up above 3/2 of the target variance, down only
+    // when half the ratio would stay below 1/2 of it.
+    // Going up jumps to the ratio that should meet the target, as long as the movement during the longer
+    // conversion stays well inside the target. Going down is one step at a time, after twice the dwell.
+    if ((OSR_Index < Max_Index) && (2 * Noise_Var_Q8 > 3 * Target_Var_Q8))
+    {
+        int Index = OSR_Index;
+        int64_t Expected_Var_Q8 = Noise_Var_Q8;
+        
+        while ((Index < Max_Index) && (Expected_Var_Q8 > Target_Var_Q8) && (3 * Motion_Var_Q8(Motion, Index + 1, Elapsed_us) <= 2 * Target_Var_Q8))
+        {
+            Index++;
+            Expected_Var_Q8 >>= 1;
+        }
+        
+        if (Index != OSR_Index)
+        {
+            Apply(Index);
+            return true;
+        }
+    }
+    else if ((OSR_Index > 0) && (Dwell >= 2 * MPL_ADAPTIVE_DWELL) && (4 * Noise_Var_Q8 < Target_Var_Q8))   // Still below half the target variance at half the ratio: save the conversion time.
+    {
+        Apply(OSR_Index - 1);
+        return true;
+    }
+    
+    return false;
+}
+
+int64_t MPL3115A2_Adaptive_OSR::Motion_Var_Q8(int64_t Motion, int Index, uint32_t Elapsed_us)  // Squared movement during one conversion at ratio 1 << Index, less the part explained by noise in the trend.
+{
+    int64_t Conversion_us = MPL_Conversion_Time_Table_us[Index];
+    int64_t Motion_Q4 = Motion * Conversion_us * 16 / 1000000;
+    
+    // Noise of the trend: variance of one rate sample (2 x Noise_Var / Elapsed^2) times its weight in the average
+    // (Elapsed / 2 x MPL_ADAPTIVE_TREND_US), scaled to one conversion.
+    int64_t Uncertainty_Q8 = Noise_Var_Q8 * Conversion_us / Elapsed_us * Conversion_us / MPL_ADAPTIVE_TREND_US;
+    int64_t Var_Q8 = Motion_Q4 * Motion_Q4 - Uncertainty_Q8;
+    
+    return (Var_Q8 > 0) ? Var_Q8 : 0;
+}
+
+void MPL3115A2_Adaptive_OSR::Apply(int Index)  // Write the new ratio and rescale the noise estimate.
+{
+    if (Index > OSR_Index)
+    {
+        Noise_Var_Q8 >>= (Index - OSR_Index);
+    }
+    else
+    {
+        Noise_Var_Q8 <<= (OSR_Index - Index);
+    }
+    
+    OSR_Index = Index;
+    Dwell = 0;
+    Switch_Count++;
+    
+    Sensor->MPL_Set_Oversampling((char)(1 << Index));
+}
+
+char MPL3115A2_Adaptive_OSR::Oversampling()  // Ratio selected by the controller: 1 to 128.
+{
+    return (char)(1 << OSR_Index);
+}
+
+int32_t MPL3115A2_Adaptive_OSR::Noise()  // Estimated standard deviation of one sample at the current ratio, rounded.
+{
+    return (int32_t)((MPL_Adaptive_Sqrt((uint64_t)Noise_Var_Q8) + 8) >> 4);
+}
+
+int32_t MPL3115A2_Adaptive_OSR::Rate()  // Smoothed rate of change, units per second.
+{
+    return Trend_Rate;
+}
+
+uint32_t MPL3115A2_Adaptive_OSR::Switches()  // CTRL_REG1 writes done by the controller since it was created.
+{
+    return Switch_Count;
+}
@@ -0,0 +1,56 @@
+#include "mbed.h"
+#ifndef MPL3115A2_ADAPTIVE_H_
+#define MPL3115A2_ADAPTIVE_H_
+
+#include "MPL3115A2_IO.h"
+
+#define MPL_ADAPTIVE_DWELL        8   // Samples between two noise-driven OSR changes.
+#define MPL_ADAPTIVE_MOTION_DWELL 2   // Samples between two motion-driven OSR drops.
+#define MPL_ADAPTIVE_TREND_US 1000000 // Averaging time of the rate of change.
+
+class MPL3115A2_Adaptive_OSR   // Picks the oversampling ratio from the measured noise and the rate of change: high OSR while stationary, low OSR (short conversions) while the signal moves.
+{
+
+public:
+
+    MPL3115A2_Adaptive_OSR(MPL3115A2 *Sensor, int32_t Noise_Target, int Latency_Budget_us);  // Noise_Target: wanted standard deviation in the units of the sample, Q18.2 Pa in Barometer mode or Q16.4 m in Altimeter mode. Latency_Budget_us: longest conversion time allowed.
+
+    bool Update(const MPL_Sample &Sample);  // Feed every new sample. The change is taken against the previous sample. Returns 'true' when the OSR was changed.
+
+    bool Update(const MPL_Frame &Frame);  // Same, with the change taken from the OUT_P_DELTA registers.
+
+    char Oversampling();  // Ratio selected by the controller: 1 to 128.
+
+    int32_t Noise();  // Estimated standard deviation of one sample at the current ratio, same units as Noise_Target.
+
+    int32_t Rate();  // Smoothed rate of change: units of the sample per second.
+
+    uint32_t Switches();  // CTRL_REG1 writes done by the controller since it was created.
+
+private:
+
+    bool Update_Delta(int32_t Delta, bool Bar_Mode, uint32_t Time_us);  // Statistics update and decision, one call per sample. Time_us: timestamp of the sample.
+
+    int64_t Motion_Var_Q8(int64_t Motion, int Index, uint32_t Elapsed_us);  // Squared movement during one conversion at ratio 1 << Index, Q8, noise of the trend removed.
+
+    void Apply(int Index);  // Write the new ratio and rescale the noise estimate.
+
+    MPL3115A2 *Sensor;
+
+    int64_t Target_Var_Q8;  // Noise_Target squared, Q8
+    int Max_Index;          // Largest ratio allowed by the latency budget: OSR = 1 << Max_Index
+    int OSR_Index;          // Current ratio: OSR = 1 << OSR_Index
+
+    int64_t Noise_Var_Q8;   // Estimated variance of one sample, Q8
+    int32_t Trend_Rate;     // Units per second
+    int32_t Previous_Value;
+    uint32_t Previous_Time_us;
+    bool Have_Previous;
+    bool Previous_Bar_Mode;
+    int Dwell;              // Samples since the last change
+
+    uint32_t Switch_Count;
+
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "MPL3115A2_Altitude.h"
+
+#define MPL_G_TABLE_START_Q2  80000   // 20000 Pa in Q18.2
+#define MPL_G_TABLE_STEP_BITS 10      // 256 Pa = 1024 LSB of Q18.2
+#define MPL_G_TABLE_SEGMENTS  352
+
+// G(P) = P^0.1902632 in Q24 for P = 20000 + 256 * i Pa, i = 0..352. Generated offline: round((20000 + 256 * i) ** 0.1902632 * 2 ** 24)
+static const uint32_t G_Table[MPL_G_TABLE_SEGMENTS + 1] =
+{
+    110419970, 110687501, 110952307, 111214451, 111473991, 111730985, 111985487, 112237551,
+    112487229, 112734570, 112979623, 113222435, 113463051, 113701514, 113937868, 114172153,
+    114404410, 114634677, 114862993, 115089393, 115313914, 115536589, 115757453, 115976537,
+    116193875, 116409496, 116623430, 116835708, 117046356, 117255403, 117462876, 117668801,
+    117873204, 118076109, 118277541, 118477523, 118676080, 118873232, 119069002, 119263412,
+    119456483, 119648235, 119838687, 120027861, 120215773, 120402444, 120587892, 120772133,
+    120955186, 121137067, 121317794, 121497382, 121675847, 121853205, 122029472, 122204661,
+    122378788, 122551867, 122723912, 122894936, 123064954, 123233978, 123402020, 123569095,
+    123735213, 123900388, 124064631, 124227954, 124390368, 124551885, 124712515, 124872269,
+    125031158, 125189193, 125346383, 125502738, 125658269, 125812985, 125966895, 126120010,
+    126272337, 126423886, 126574666, 126724685, 126873952, 127022476, 127170264, 127317325,
+    127463666, 127609296, 127754222, 127898451, 128041992, 128184851, 128327036, 128468553,
+    128609410, 128749614, 128889171, 129028087, 129166370, 129304026, 129441061, 129577481,
+    129713293, 129848502, 129983115, 130117137, 130250574, 130383432, 130515716, 130647432,
+    130778585, 130909181, 131039225, 131168721, 131297676, 131426095, 131553981, 131681340,
+    131808178, 131934498, 132060305, 132185604, 132310400, 132434697, 132558500, 132681812,
+    132804639, 132926984, 133048851, 133170245, 133291171, 133411631, 133531630, 133651172,
+    133770260, 133888899, 134007092, 134124843, 134242156, 134359035, 134475482, 134591501,
+    134707097, 134822272, 134937029, 135051373, 135165306, 135278832, 135391954, 135504675,
+    135616999, 135728928, 135840465, 135951614, 136062378, 136172759, 136282761, 136392386,
+    136501638, 136610518, 136719031, 136827178, 136934963, 137042387, 137149455, 137256168,
+    137362529, 137468541, 137574206, 137679527, 137784506, 137889145, 137993448, 138097416,
+    138201053, 138304359, 138407338, 138509993, 138612324, 138714335, 138816027, 138917404,
+    139018467, 139119218, 139219659, 139319793, 139419621, 139519147, 139618371, 139717295,
+    139815923, 139914255, 140012295, 140110042, 140207501, 140304672, 140401558, 140498159,
+    140594479, 140690519, 140786281, 140881766, 140976977, 141071915, 141166581, 141260978,
+    141355108, 141448971, 141542571, 141635907, 141728983, 141821799, 141914357, 142006659,
+    142098706, 142190501, 142282044, 142373336, 142464381, 142555178, 142645730, 142736038,
+    142826104, 142915928, 143005513, 143094860, 143183970, 143272844, 143361484, 143449892,
+    143538069, 143626015, 143713733, 143801224, 143888489, 143975529, 144062345, 144148940,
+    144235314, 144321468, 144407404, 144493123, 144578626, 144663914, 144748989, 144833851,
+    144918503, 145002944, 145087177, 145171202, 145255021, 145338634, 145422043, 145505249,
+    145588253, 145671056, 145753660, 145836064, 145918271, 146000281, 146082096, 146163716,
+    146245142, 146326376, 146407419, 146488271, 146568934, 146649408, 146729694, 146809795,
+    146889709, 146969439, 147048985, 147128349, 147207531, 147286532, 147365353, 147443995,
+    147522459, 147600745, 147678856, 147756790, 147834551, 147912138, 147989551, 148066793,
+    148143864, 148220765, 148297496, 148374058, 148450453, 148526681, 148602742, 148678639,
+    148754371, 148829939, 148905344, 148980587, 149055668, 149130589, 149205350, 149279952,
+    149354396, 149428682, 149502812, 149576785, 149650603, 149724266, 149797775, 149871131,
+    149944335, 150017386, 150090287, 150163037, 150235638, 150308090, 150380393, 150452549,
+    150524557, 150596420, 150668136, 150739708, 150811136, 150882419, 150953560, 151024558,
+    151095415, 151166130, 151236705, 151307140, 151377436, 151447593, 151517612, 151587493,
+    151657238, 151726847, 151796319, 151865657, 151934861, 152003930, 152072866, 152141670,
+    152210341, 152278880, 152347289, 152415567, 152483715, 152551734, 152619624, 152687386,
+    152755020
+};
+
+static int32_t MPL_Altitude_G(int32_t Pressure_Fixed)  // Linear interpolation of G_Table. Pressure is clamped to the table range.
+{
+    int32_t Offset = Pressure_Fixed - MPL_G_TABLE_START_Q2;
+    
+    if (Offset < 0){Offset = 0;}
+    if (Offset >= (MPL_G_TABLE_SEGMENTS << MPL_G_TABLE_STEP_BITS)){Offset = (MPL_G_TABLE_SEGMENTS << MPL_G_TABLE_STEP_BITS) - 1;}
+    
+    int32_t Index = Offset >> MPL_G_TABLE_STEP_BITS;
+    int32_t Fraction = Offset & ((1 << MPL_G_TABLE_STEP_BITS) - 1);
+    int32_t Low = (int32_t)G_Table[Index];
+    int32_t Slope = (int32_t)G_Table[Index + 1] - Low;   // At most ~2.7e5 per segment, times 1023 still fits 32 bits.
+    
+    return Low + ((Slope * Fraction) >> MPL_G_TABLE_STEP_BITS);
+}
+
+void MPL_Altitude_Set_Reference(MPL_Altitude_Reference &Reference, uint32_t Reference_Pa, int8_t Offset_m)  // Done once per reference change: the only division.
+{
+    if (Reference_Pa > 110000){Reference_Pa = 110000;}   // Same limits as MPL_Set_Barometric_Reference().
+    if (Reference_Pa < 50000){Reference_Pa = 50000;}
+    
+    Reference.G0 = MPL_Altitude_G((int32_t)Reference_Pa * 4);
+    Reference.Scale = (uint32_t)((70929232ULL << 32) / (100ULL * (uint64_t)Reference.G0));   // 70929232 = 44330.77 * 16 * 100
+    Reference.Offset_Fixed = (int32_t)Offset_m * 16;
+}
+
+int32_t MPL_Altitude_From_Pressure(const MPL_Altitude_Reference &Reference, int32_t Pressure_Fixed)  // Pressure in Q18.2 Pa -> Altitude in Q16.4 m.
+{
+    int64_t Product = (int64_t)(Reference.G0 - MPL_Altitude_G(Pressure_Fixed)) * (int64_t)Reference.Scale;   // Single SMULL-class multiply on Cortex-M3
+    
+    return (int32_t)((Product + 0x80000000LL) >> 32) + Reference.Offset_Fixed;
+}
@@ -0,0 +1,37 @@
+/*!
+ *   Pressure to altitude conversion on the host side, integer only.
+ *
+ *   Uses the same barometric formula as the device in Altimeter mode:
+ *
+ *      h = 44330.77 * (1 - (P / P0)^0.1902632)       P0 = BAR_IN reference (MPL_Set_Barometric_Reference())
+ *
+ *   rewritten as h = 44330.77 * (G(P0) - G(P)) / G(P0) with G(P) = P^0.1902632. G is a 353 entry
+ *   table (256 Pa steps from 20 kPa to 110.1 kPa, Q24) with linear interpolation. Everything that
+ *   depends on P0 only (G(P0) and the reciprocal scale) is computed once per reference change,
+ *   so each conversion is one table interpolation plus one 32x32->64 multiply.
+ *
+ *   Error bound against the exact formula (includes the Q16.4 output rounding):
+ *      P in [20, 110] kPa, P0 in [50, 110] kPa:   |error| <= 0.15 m
+ *      P in [70, 105] kPa, P0 in [95, 105] kPa:   |error| <= 0.045 m  (below 1 LSB of the device output, 0.0625 m)
+ *
+ *   With this the sensor can stay in Barometer mode and deliver Pressure and Altitude from one conversion.
+ *
+*/
+
+#ifndef MPL3115A2_ALTITUDE_H_
+#define MPL3115A2_ALTITUDE_H_
+
+#include <stdint.h>    // to handle uintN_t and intN_t integer types
+
+struct MPL_Altitude_Reference   // Precomputed terms for one BAR_IN reference and OFF_H offset.
+{
+    int32_t G0;              // G(P0) in Q24
+    uint32_t Scale;          // 44330.77 * 16 * 2^32 / G0: turns (G0 - G) into Q16.4 meters
+    int32_t Offset_Fixed;    // OFF_H altitude offset in Q16.4 m
+};
+
+void MPL_Altitude_Set_Reference(MPL_Altitude_Reference &Reference, uint32_t Reference_Pa, int8_t Offset_m);  // Reference_Pa: sea level pressure [50000, 110000] Pa. Offset_m: same meaning as OFF_H.
+
+int32_t MPL_Altitude_From_Pressure(const MPL_Altitude_Reference &Reference, int32_t Pressure_Fixed);  // Pressure in Q18.2 Pa -> Altitude in Q16.4 m.
+
+#endif
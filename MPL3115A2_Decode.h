@@ -0,0 +1,58 @@
+/*!
+ *   Integer decoding of MPL3115A2 output registers. No floating point is involved so the
+ *   functions are cheap on cores without an FPU (LPC1768 / Cortex-M3).
+ *
+ *   Fixed-point formats returned:
+ *      Pressure     Q18.2 Pa  (1 LSB = 0.25 Pa)    unsigned 20-bit {OUT_P_MSB, OUT_P_CSB, OUT_P_LSB[7:4]}
+ *      Altitude     Q16.4 m   (1 LSB = 0.0625 m)   signed 20-bit   {OUT_P_MSB, OUT_P_CSB, OUT_P_LSB[7:4]}
+ *      Temperature  Q8.4 C    (1 LSB = 0.0625 C)   signed 12-bit   {OUT_T_MSB, OUT_T_LSB[7:4]}
+ *      Pressure change is the signed version of the Pressure format.
+ *
+*/
+
+#ifndef MPL3115A2_DECODE_H_
+#define MPL3115A2_DECODE_H_
+
+#include <stdint.h>    // to handle uintN_t and intN_t integer types
+
+#define MPL_PRESSURE_FRACTION_BITS    2   // Q18.2
+#define MPL_ALTITUDE_FRACTION_BITS    4   // Q16.4
+#define MPL_TEMPERATURE_FRACTION_BITS 4   // Q8.4
+
+#define MPL_NO_READING ((int32_t)0x80000000)   // Returned by the _Fixed getters when the conversion timed out. Outside every 20-bit and 12-bit range.
+
+static inline int32_t MPL_Decode_Unsigned_20(const char *Raw)  // {MSB, CSB, LSB[7:4]} as an unsigned 20-bit value.
+{
+    return (int32_t)( ((uint32_t)(uint8_t)Raw[0] << 12) | ((uint32_t)(uint8_t)Raw[1] << 4) | ((uint32_t)(uint8_t)Raw[2] >> 4) );
+}
+
+static inline int32_t MPL_Decode_Signed_20(const char *Raw)  // {MSB, CSB, LSB[7:4]} as a 2's complement 20-bit value.
+{
+    int32_t Value = MPL_Decode_Unsigned_20(Raw);
+
+    if ((Value & 0x00080000) != 0)  // Sign bit 19 set: pad with '1's all the way to bit 31.
+    {
+        Value |= (int32_t)0xFFF00000;
+    }
+
+    return Value;
+}
+
+static inline int32_t MPL_Decode_Signed_12(const char *Raw)  // {MSB, LSB[7:4]} as a 2's complement 12-bit value.
+{
+    int32_t Value = (int32_t)( ((uint32_t)(uint8_t)Raw[0] << 4) | ((uint32_t)(uint8_t)Raw[1] >> 4) );
+
+    if ((Value & 0x00000800) != 0)  // Sign bit 11 set.
+    {
+        Value |= (int32_t)0xFFFFF000;
+    }
+
+    return Value;
+}
+
+static inline int32_t MPL_Decode_Pressure(const char *Raw)        { return MPL_Decode_Unsigned_20(Raw); }  // Q18.2 Pa
+static inline int32_t MPL_Decode_Pressure_Change(const char *Raw) { return MPL_Decode_Signed_20(Raw); }    // Q18.2 Pa, signed
+static inline int32_t MPL_Decode_Altitude(const char *Raw)        { return MPL_Decode_Signed_20(Raw); }    // Q16.4 m
+static inline int32_t MPL_Decode_Temperature(const char *Raw)     { return MPL_Decode_Signed_12(Raw); }    // Q8.4 C
+
+#endif
@@ -0,0 +1,160 @@
+#include "MPL3115A2_Decode_Batch.h"
+#include "MPL3115A2_Decode.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// The vector kernels gather two little-endian 32-bit words per sample:
+//    Word_P = bytes 0..3 of the sample:  P_MSB | P_CSB << 8 | P_LSB << 16 | T_MSB << 24
+//    Word_T = bytes 1..4 of the sample:  P_CSB | P_LSB << 8 | T_MSB << 16 | T_LSB << 24
+// and rebuild the big-endian register fields with shifts and masks:
+//    P20 = (P_MSB << 12) | (P_CSB << 4) | (P_LSB >> 4)
+//    T12 = (T_MSB << 4) | (T_LSB >> 4)
+// Sign extension is an arithmetic right shift of the field moved to the top of the lane, which is
+// exactly what MPL_Decode_Signed_20()/MPL_Decode_Signed_12() compute.
+
+static void MPL_Decode_Batch_Tail(const char *Raw, int First, int Count, int32_t *Value, int32_t *Temperature, bool Signed_Value)  // Scalar loop, also the remainder of the vector kernels.
+{
+    for (int i = First; i < Count; i++)
+    {
+        const char *Sample = &Raw[i * MPL_RAW_SAMPLE_BYTES];
+
+        Value[i] = Signed_Value ? MPL_Decode_Altitude(Sample) : MPL_Decode_Pressure(Sample);
+
+        if (Temperature != NULL)
+        {
+            Temperature[i] = MPL_Decode_Temperature(&Sample[3]);
+        }
+    }
+}
+
+#if defined(__AVX2__)
+
+static int MPL_Decode_Batch_Vector(const char *Raw, int Count, int32_t *Value, int32_t *Temperature, bool Signed_Value)  // 8 samples per step. Returns the number of samples decoded.
+{
+    const __m256i Offsets = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 30, 35);
+    const __m256i Byte_Mask = _mm256_set1_epi32(0xFF);
+    int i = 0;
+
+    for (; (i + 8) <= Count; i += 8)
+    {
+        const char *Base = &Raw[i * MPL_RAW_SAMPLE_BYTES];
+        __m256i Word_P = _mm256_i32gather_epi32((const int *)Base, Offsets, 1);        // Last byte read: 35 + 3 = 38 < 40
+        __m256i Word_T = _mm256_i32gather_epi32((const int *)(Base + 1), Offsets, 1);  // Last byte read: 36 + 3 = 39 < 40
+
+        __m256i P = _mm256_or_si256(_mm256_or_si256(
+                        _mm256_slli_epi32(_mm256_and_si256(Word_P, Byte_Mask), 12),
+                        _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(Word_P, 8), Byte_Mask), 4)),
+                        _mm256_and_si256(_mm256_srli_epi32(Word_P, 20), _mm256_set1_epi32(0x0F)));
+
+        if (Signed_Value)
+        {
+            P = _mm256_srai_epi32(_mm256_slli_epi32(P, 12), 12);
+        }
+
+        _mm256_storeu_si256((__m256i *)&Value[i], P);
+
+        if (Temperature != NULL)
+        {
+            __m256i T = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(Word_T, 16), Byte_Mask), 4),
+                                        _mm256_srli_epi32(Word_T, 28));
+
+            _mm256_storeu_si256((__m256i *)&Temperature[i], _mm256_srai_epi32(_mm256_slli_epi32(T, 20), 20));
+        }
+    }
+
+    return i;
+}
+
+#elif defined(__SSE2__)
+
+static inline uint32_t MPL_Load_32(const char *Address)  // Unaligned little-endian load.
+{
+    uint32_t Word;
+    memcpy(&Word, Address, sizeof(Word));
+    return Word;
+}
+
+static int MPL_Decode_Batch_Vector(const char *Raw, int Count, int32_t *Value, int32_t *Temperature, bool Signed_Value)  // 4 samples per step. Returns the number of samples decoded.
+{
+    const __m128i Byte_Mask = _mm_set1_epi32(0xFF);
+    int i = 0;
+
+    for (; (i + 4) <= Count; i += 4)
+    {
+        const char *Base = &Raw[i * MPL_RAW_SAMPLE_BYTES];
+        __m128i Word_P = _mm_setr_epi32((int)MPL_Load_32(Base), (int)MPL_Load_32(Base + 5), (int)MPL_Load_32(Base + 10), (int)MPL_Load_32(Base + 15));  // SSE2 has no gather or byte shuffle.
+        __m128i Word_T = _mm_setr_epi32((int)MPL_Load_32(Base + 1), (int)MPL_Load_32(Base + 6), (int)MPL_Load_32(Base + 11), (int)MPL_Load_32(Base + 16));
+
+        __m128i P = _mm_or_si128(_mm_or_si128(
+                        _mm_slli_epi32(_mm_and_si128(Word_P, Byte_Mask), 12),
+                        _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(Word_P, 8), Byte_Mask), 4)),
+                        _mm_and_si128(_mm_srli_epi32(Word_P, 20), _mm_set1_epi32(0x0F)));
+
+        if (Signed_Value)
+        {
+            P = _mm_srai_epi32(_mm_slli_epi32(P, 12), 12);
+        }
+
+        _mm_storeu_si128((__m128i *)&Value[i], P);
+
+        if (Temperature != NULL)
+        {
+            __m128i T = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(Word_T, 16), Byte_Mask), 4),
+                                     _mm_srli_epi32(Word_T, 28));
+
+            _mm_storeu_si128((__m128i *)&Temperature[i], _mm_srai_epi32(_mm_slli_epi32(T, 20), 20));
+        }
+    }
+
+    return i;
+}
+
+#else
+
+static int MPL_Decode_Batch_Vector(const char *Raw, int Count, int32_t *Value, int32_t *Temperature, bool Signed_Value)  // No vector unit: everything is left to the scalar loop.
+{
+    (void)Raw; (void)Count; (void)Value; (void)Temperature; (void)Signed_Value;
+    return 0;
+}
+
+#endif
+
+void MPL_Decode_Batch_Pressure(const char *Raw, int Count, int32_t *Pressure, int32_t *Temperature)  // Samples taken in Barometer mode.
+{
+    int Done = MPL_Decode_Batch_Vector(Raw, Count, Pressure, Temperature, false);
+
+    MPL_Decode_Batch_Tail(Raw, Done, Count, Pressure, Temperature, false);
+}
+
+void MPL_Decode_Batch_Altitude(const char *Raw, int Count, int32_t *Altitude, int32_t *Temperature)  // Samples taken in Altimeter mode.
+{
+    int Done = MPL_Decode_Batch_Vector(Raw, Count, Altitude, Temperature, true);
+
+    MPL_Decode_Batch_Tail(Raw, Done, Count, Altitude, Temperature, true);
+}
+
+void MPL_Decode_Batch_Pressure_Scalar(const char *Raw, int Count, int32_t *Pressure, int32_t *Temperature)  // Reference implementation.
+{
+    MPL_Decode_Batch_Tail(Raw, 0, Count, Pressure, Temperature, false);
+}
+
+void MPL_Decode_Batch_Altitude_Scalar(const char *Raw, int Count, int32_t *Altitude, int32_t *Temperature)  // Reference implementation.
+{
+    MPL_Decode_Batch_Tail(Raw, 0, Count, Altitude, Temperature, true);
+}
+
+const char *MPL_Decode_Batch_Kernel()  // The kernel compiled into MPL_Decode_Batch_*().
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,32 @@
+/*!
+ *   Batch decoding of raw MPL3115A2 samples into structure-of-arrays outputs.
+ *
+ *   Input is an array of 5-byte raw samples laid out as read from OUT_P_MSB..OUT_T_LSB or F_DATA
+ *   (MPL_Sample::Raw, MPL_Drain_FIFO(), log files): P_MSB, P_CSB, P_LSB, T_MSB, T_LSB.
+ *   Outputs use the fixed-point formats of MPL3115A2_Decode.h (Q18.2 Pa, Q16.4 m, Q8.4 C).
+ *
+ *   MPL_Decode_Batch_*() picks the widest kernel the compiler targets: AVX2 (8 samples per step)
+ *   when __AVX2__ is defined, SSE2 (4 samples per step) when __SSE2__ is defined, otherwise the scalar
+ *   loop (LPC1768 firmware). The choice is made at compile time. All kernels give bit-identical results.
+ *   The _Scalar versions are always available as the reference.
+ *
+*/
+
+#ifndef MPL3115A2_DECODE_BATCH_H_
+#define MPL3115A2_DECODE_BATCH_H_
+
+#include <stdint.h>    // to handle uintN_t and intN_t integer types
+
+#define MPL_RAW_SAMPLE_BYTES 5   // P_MSB, P_CSB, P_LSB, T_MSB, T_LSB
+
+void MPL_Decode_Batch_Pressure(const char *Raw, int Count, int32_t *Pressure, int32_t *Temperature);  // Samples taken in Barometer mode. Temperature may be NULL.
+
+void MPL_Decode_Batch_Altitude(const char *Raw, int Count, int32_t *Altitude, int32_t *Temperature);  // Samples taken in Altimeter mode. Temperature may be NULL.
+
+void MPL_Decode_Batch_Pressure_Scalar(const char *Raw, int Count, int32_t *Pressure, int32_t *Temperature);  // Reference implementation.
+
+void MPL_Decode_Batch_Altitude_Scalar(const char *Raw, int Count, int32_t *Altitude, int32_t *Temperature);  // Reference implementation.
+
+const char *MPL_Decode_Batch_Kernel();  // "avx2", "sse2" or "scalar": the kernel compiled into MPL_Decode_Batch_*().
+
+#endif
@@ -0,0 +1,77 @@
+#include "MPL3115A2_Group.h"
+
+
+MPL3115A2_Group::MPL3115A2_Group()
+{
+    Sensor_Count = 0;
+}
+
+bool MPL3115A2_Group::Add(MPL3115A2 *Sensor)  // Register a sensor. Returns 'false' when the group is full.
+{
+    if ((Sensor == NULL) || (Sensor_Count >= MPL_GROUP_MAX_SENSORS))
+    {
+        return false;
+    }
+    
+    Sensors[Sensor_Count] = Sensor;
+    Sensor_Count++;
+    
+    return true;
+}
+
+int MPL3115A2_Group::Count()  // Number of registered sensors.
+{
+    return Sensor_Count;
+}
+
+uint32_t MPL3115A2_Group::Sample_All(MPL_Sample *Samples, int Timeout_us)  // Trigger all, then collect each result as soon as its conversion completes.
+{
+    uint32_t Pending = 0;
+    uint32_t Done = 0;
+    int Shortest_us = 0;
+    int Longest_us = 0;
+    Timer Elapsed;
+    
+    for (int i = 0; i < Sensor_Count; i++)  // Back-to-back triggers: all conversion windows overlap.
+    {
+        Sensors[i]->MPL_One_Shot_Measure();
+        Pending |= (1UL << i);
+        
+        int Conversion_us = Sensors[i]->MPL_Conversion_Time_us();
+        
+        if ((Shortest_us == 0) || (Conversion_us < Shortest_us)){Shortest_us = Conversion_us;}
+        if (Conversion_us > Longest_us){Longest_us = Conversion_us;}
+    }
+    
+    if (Timeout_us <= 0)
+    {
+        Timeout_us = 2 * Longest_us;
+    }
+    
+    Elapsed.start();
+    
+    if (Pending != 0)
+    {
+        wait_us(Shortest_us);  // No sensor can be ready earlier. Keeps every bus quiet for the bulk of the conversion.
+    }
+    
+    while ((Pending != 0) && (Elapsed.read_us() < Timeout_us))
+    {
+        for (int i = 0; i < Sensor_Count; i++)  // Round-robin: each sensor is read as soon as it is done, in whatever order they finish.
+        {
+            if (((Pending & (1UL << i)) != 0) && (Sensors[i]->MPL_Conversion_Complete() == true))
+            {
+                Sensors[i]->MPL_Fetch_Sample(Samples[i]);
+                Pending &= ~(1UL << i);
+                Done |= (1UL << i);
+            }
+        }
+        
+        if (Pending != 0)
+        {
+            wait_us(MPL_GROUP_POLL_US);  // Spacing between status checks so the buses are not hammered.
+        }
+    }
+    
+    return Done;
+}
@@ -0,0 +1,31 @@
+#include "mbed.h"
+#ifndef MPL3115A2_GROUP_H_
+#define MPL3115A2_GROUP_H_
+
+#include "MPL3115A2_IO.h"
+
+#define MPL_GROUP_MAX_SENSORS 8     // Sensors per group. The MPL3115A2 address is fixed, so every sensor sits on its own I2C bus.
+#define MPL_GROUP_POLL_US     1000  // Interval between completion checks once the shortest conversion time has elapsed.
+
+class MPL3115A2_Group   // Samples several MPL3115A2 with overlapped conversions: N sensors take about one conversion time instead of N.
+{
+
+public:
+
+    MPL3115A2_Group();
+
+    bool Add(MPL3115A2 *Sensor);  // Register a sensor. Returns 'false' when the group is full.
+
+    int Count();  // Number of registered sensors.
+
+    uint32_t Sample_All(MPL_Sample *Samples, int Timeout_us = 0);  // Trigger OST on every sensor, then collect each result as soon as its conversion completes. Samples[i] belongs to the i-th added sensor.
+                                                                    // Returns a bit mask of the sensors that delivered a sample. Timeout_us = 0 uses twice the longest conversion time of the group.
+
+private:
+
+    MPL3115A2 *Sensors[MPL_GROUP_MAX_SENSORS];
+    int Sensor_Count;
+
+};
+
+#endif
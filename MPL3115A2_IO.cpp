@@ -1,12 +1,88 @@
 #include "MPL3115A2_IO.h"
 #include "MPL3115A2_REGISTER_MAP.h"
+#include "MPL3115A2_Decode.h"
+#include <math.h>      // NAN
 
+#if DEVICE_I2C_ASYNCH
+// States of the asynchronous sample chain started by MPL_Start_Sample().
+#define MPL_ASYNC_IDLE    0
+#define MPL_ASYNC_TRIGGER 1   // OST write in progress.
+#define MPL_ASYNC_CONVERT 2   // Waiting for the conversion to complete.
+#define MPL_ASYNC_CHECK   3   // CTRL_REG1 read in progress to confirm OST is cleared.
+#define MPL_ASYNC_READ    4   // OUT_P_MSB..OUT_T_LSB burst read in progress.
 
-MPL3115A2::MPL3115A2(PinName sda, PinName scl) : _i2c(sda, scl)
+#endif
+
+
+#define MPL_FRAME_RETRIES 3   // MPL_Read_Frame() attempts when acquisitions keep landing between its two bursts.
+#define MPL_DR_FLAGS      (DR_PTOW | DR_POW | DR_TOW | DR_PTDR | DR_PDR | DR_TDR)
+
+
+#ifndef MPL3115A2_BUS_STATS
+inline int MPL3115A2::MPL_Bus_Write(const char *data, int length, bool repeated)  // Instrumentation compiled out: inlined straight into every caller.
+{
+    return _i2c.write(MPL3115A2_WRITE, data, length, repeated);
+}
+
+inline int MPL3115A2::MPL_Bus_Read(char *data, int length, bool repeated)
+{
+    return _i2c.read(MPL3115A2_READ, data, length, repeated);
+}
+#endif
+
+
+MPL3115A2::MPL3115A2(PinName sda, PinName scl, PinName int_pin) : _i2c(sda, scl)
 {
     _i2c.frequency(frequency);   // Set I2C object frequency too 400 KHz.
     Bar_Mode = true;        // Default to Barometer mode @ startup. 
     is_Reset = false;         // Defaults to not-reset
+    Shadow_Valid = false;     // Control registers are loaded from the device on first use. The MCU may restart without the sensor being reset.
+    Shadow_Verify = false;
+    FIFO_Setup = F_SETUP_F_MODE_DISABLED;
+    
+    Bar_Reference_Pa = 101326;   // Device default (BAR_IN = 0xC5E7). Reloaded with the control registers.
+    Altitude_Trim = 0;
+    MPL_Altitude_Set_Reference(Altitude_Reference, Bar_Reference_Pa, Altitude_Trim);
+    Software_Altitude = false;
+    
+    Staged_Mask = 0;
+    Batching = false;
+    
+    Int_Pin = NULL;           // The interrupt pin is optional. Without it the driver polls CTRL_REG1.
+    Data_Ready_Mode = false;
+    Data_Ready = false;
+    Data_Ready_us = 0;
+    Trigger_us = 0;
+    Active_us = 0;
+    Active_Known = false;
+    Low_Power_FIFO = false;
+    Low_Power_Step_us = 0;
+    Low_Power_Wake_us = 0;
+    memset(&Duty, 0, sizeof(Duty));
+    
+#if DEVICE_I2C_ASYNCH
+    Async_Sample = NULL;
+    Async_State = MPL_ASYNC_IDLE;
+#endif
+    
+#ifdef MPL3115A2_BUS_STATS
+    MPL_Reset_Bus_Stats();
+#endif
+    
+    if (int_pin != NC)
+    {
+        Int_Pin = new InterruptIn(int_pin);
+    }
+}
+
+MPL3115A2::~MPL3115A2()
+{
+    if (Int_Pin != NULL)
+    {
+        Int_Pin->rise(NULL);   // An edge after this point must not call into the destroyed instance.
+        Int_Pin->fall(NULL);
+        delete Int_Pin;
+    }
 }
 
 void MPL3115A2::MPL_Init()  // Used to initialize proper settings: Oversampling, Device Mode, Interrupts etc. TBD
@@ -18,8 +94,8 @@ char MPL3115A2::MPL_Get_Status()  // Reads the STATUS register and returns the c
 {
     char temp[2];
     temp[0] = STATUS;
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
     
     return temp[0];
 }
@@ -28,314 +104,422 @@ char MPL3115A2::MPL_Who_Am_I_()
 {
     char temp[2];
     temp[0] = WHO_AM_I;
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
     
     return temp[0];
 }
 
-double MPL3115A2::MPL_Get_Pressure()     // Returns the Atmospheric Pressure reading.
+int32_t MPL3115A2::MPL_Get_Pressure_Fixed()     // Returns the Atmospheric Pressure reading. Q18.2 Pa
 {
     char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    MPL_One_Shot_Measure();  // Initiate the measurement. 
- 
-    //wait_ms(700);  Alternative to polling DR_PDR bit to see if the data is available for reading.
-    temp[0] = 0xFF;  // Prime the while() loop.
+    if (Bar_Mode == false)   // Verify that the device is in Barometer mode before the trigger, so the conversion is done in the mode that is read back.
+    {
+        MPL_Barometer_Mode();   //Change to the Barometer Mode.
+    }
     
-    while((temp[0] & CTRL_REG1_OST) != 0 )  // Poll the OST binary in CTRL_REG1 register to see when oversampling is completed and data is available. The bit is auto-clear @FIFO = 00. Poll while 1. 
-    {    
-        temp[0] = CTRL_REG1;                     
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,1);
+    MPL_One_Shot_Measure();  // Initiate the measurement. 
     
-    }
-     
-    if (Bar_Mode == true)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
+    if (MPL_Wait_For_Conversion() == false)  // Sleep for the conversion time of the current oversampling ratio, then one OST check. Or wait for the Data Ready interrupt when it is enabled.
     {
-        temp[0] = OUT_P_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-    
+        return MPL_NO_READING;   // OUT_P/OUT_T still hold the previous conversion: do not pass it off as new.
     }
     
-    else
+    temp[0] = OUT_P_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
+    
+    return MPL_Decode_Pressure(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Pressure()     // Returns the Atmospheric Pressure reading. NAN on timeout.
+{
+    int32_t Pressure = MPL_Get_Pressure_Fixed();
+    
+    return (Pressure == MPL_NO_READING) ? NAN : 0.25 * (double)Pressure;
+}
+
+int32_t MPL3115A2::MPL_Get_Altitude_Fixed()     // Returns the Altitude reading. Q16.4 m
+{
+    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
+    
+    if (Software_Altitude == true)   // Stay in Barometer mode: no CTRL_REG1 read-modify-write, and the conversion is never thrown away by a mode switch.
     {
-        MPL_Barometer_Mode();   //Change to the Barometer Mode.
-        
-        temp[0] = OUT_P_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
+        int32_t Pressure = MPL_Get_Pressure_Fixed();
         
+        return (Pressure == MPL_NO_READING) ? MPL_NO_READING : MPL_Altitude_From_Pressure_Fixed(Pressure);
+    }
+    
+    if (Bar_Mode == true)   // Verify that the device is in Altimeter mode before the trigger, so the conversion is done in the mode that is read back.
+    {
+        MPL_Altimeter_Mode();   //Change to the Altimeter Mode.
     }
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Pressure data: 20-bit unsigned in Pa. First 18 bits {OUT_P_MSB[7:0],OUT_C_MSB[7:0],OUT_P_LSB[7:6]} is Whole and OUT_P_LSB[5:4] Fractional.
+    MPL_One_Shot_Measure();  // Initiate the measurement. 
+    
+    if (MPL_Wait_For_Conversion() == false)  // Sleep for the conversion time of the current oversampling ratio, then one OST check. Or wait for the Data Ready interrupt when it is enabled.
+    {
+        return MPL_NO_READING;   // OUT_P/OUT_T still hold the previous conversion: do not pass it off as new.
+    }
     
-    double temp_Whole = (double)( (temp[0] << 10) | (temp[1] << 2) | (temp[2] >> 6) );  // Assemble 18-bit Whole segment
+    temp[0] = OUT_P_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    double temp_Fraction = 0.25 * (double)((temp[2] >> 4) & 0x03);   // right-shift bits 5:4 and isolate. Fractional values are in increments of 0.25 Pa. i.e. 11 is 0.25*3 = 0.75 Pa. 10 is 0.25*2, and 01 is 0.25*1.
+    return MPL_Decode_Altitude(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Altitude()     // Returns the Altitude reading. NAN on timeout.
+{
+    int32_t Altitude = MPL_Get_Altitude_Fixed();
     
-    return (temp_Whole + temp_Fraction);
+    return (Altitude == MPL_NO_READING) ? NAN : 0.0625 * (double)Altitude;
 }
 
-double MPL3115A2::MPL_Get_Altitude()     // Returns the Altitude reading.
+int32_t MPL3115A2::MPL_Get_Temperature_Fixed()     // Returns Teperature reading. Q8.4 C
 {
     char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
     MPL_One_Shot_Measure();  // Initiate the measurement. 
- 
-    //wait_ms(700);  Alternative to polling DR_PDR bit to see if the data is available for reading.
     
-    temp[0] = 0xFF;  // Prime the while() loop.
+    if (MPL_Wait_For_Conversion() == false)  // Sleep for the conversion time of the current oversampling ratio, then one OST check. Or wait for the Data Ready interrupt when it is enabled.
+    {
+        return MPL_NO_READING;   // OUT_P/OUT_T still hold the previous conversion: do not pass it off as new.
+    }
     
-    while((temp[0] & CTRL_REG1_OST) != 0 )  // Poll the OST binary in CTRL_REG1 register to see when oversampling is completed and data is available. The bit is auto-clear @FIFO = 00. Poll while 1. 
-    {    
-        temp[0] = CTRL_REG1;                     
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,1);
+    temp[0] = OUT_T_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,2);
     
-    }
+    return MPL_Decode_Temperature(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Temperature()     // Returns Teperature reading. NAN on timeout.
+{
+    int32_t Temperature = MPL_Get_Temperature_Fixed();
     
-    if (Bar_Mode == false)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
-    {
-        temp[0] = OUT_P_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
+    return (Temperature == MPL_NO_READING) ? NAN : 0.0625 * (double)Temperature;
+}
+
+bool MPL3115A2::MPL_Read_Sample(MPL_Sample &Sample)  // Single acquisition of Pressure/Altitude and Temperature. One OST trigger and one 5-byte burst read.
+{
+    MPL_One_Shot_Measure();     // Initiate the measurement. Pressure/Altitude and Temperature are converted together.
     
+    if (MPL_Wait_For_Conversion() == false)  // Sleep for the conversion time, then confirm the OST bit is auto-cleared.
+    {
+        return false;           // No read: Sample keeps its previous contents.
     }
     
-    else
+    MPL_Fetch_Sample(Sample);
+    
+    return true;
+}
+
+bool MPL3115A2::MPL_Conversion_Complete()  // Non-blocking check of the acquisition started by MPL_One_Shot_Measure().
+{
+    char temp[1];
+    
+    if (Data_Ready_Mode == true)  // The interrupt flag answers without touching the bus.
     {
-        MPL_Altimeter_Mode();   //Change to the Altimeter Mode.
-        
-        temp[0] = OUT_P_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-        
+        return Data_Ready;
     }
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Altitude data: 20-bit unsigned in m. First 16 bits {OUT_P_MSB[7:0],OUT_C_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_P_LSB[7:4] is Fractional(unsigned)
+    if ((MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_SBYB) != 0)  // ACTIVE mode: the latest periodic sample is always available.
+    {
+        return true;
+    }
     
-    int temp_Whole = ( (temp[0] << 8) | temp[1] );  // Assemble 16-bit Whole segment to determine the sign next.
+    temp[0] = CTRL_REG1;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
     
-    int MSB = temp_Whole >> 15;                                 // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x00007FFF;                              // Mask to retain 15 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's.
-      {
-          temp_Whole = (temp_Whole | 0xFFFF8000 );   // 32-bit
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
+    return ((temp[0] & CTRL_REG1_OST) == 0);  // OST auto-clears once the acquisition is completed.
+}
+
+void MPL3115A2::MPL_Fetch_Sample(MPL_Sample &Sample)  // 5-byte burst read of OUT_P_MSB..OUT_T_LSB without triggering.
+{
+    Sample.Raw[0] = OUT_P_MSB;
+    MPL_Bus_Write(Sample.Raw,1,true);
+    MPL_Bus_Read(Sample.Raw,5);  // Auto-increment: OUT_P_MSB, OUT_P_CSB, OUT_P_LSB, OUT_T_MSB, OUT_T_LSB in one transaction.
     
-    double temp_Fraction = 0.0625 * (double)((temp[2] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 m. i.e. 1111 is 0.0625*15 = 0.9375 m.
+    Sample.Bar_Mode = Bar_Mode;  // The sample is converted in whatever mode the device is currently set to. No mode switching here.
     
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
+    MPL_Decode_Sample(Sample);
     
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }
+    Sample.Timestamp_us = MPL_Sample_Time_us();
 }
 
-double MPL3115A2::MPL_Get_Temperature()  // Returns Teperature reading.
+#if DEVICE_I2C_ASYNCH
+bool MPL3115A2::MPL_Start_Sample(MPL_Sample &Sample, Callback<void(bool)> Done)  // Non-blocking MPL_Read_Sample(). Every stage is started from the completion callback of the previous one.
 {
-    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
+    if ((Async_State != MPL_ASYNC_IDLE) || ((MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_SBYB) != 0))  // One-shot chain only. Use MPL_Read_Latest_Sample() in ACTIVE mode.
+    {
+        return false;
+    }
     
-    MPL_One_Shot_Measure();  // Initiate the measurement. 
- 
-    //wait_ms(700);  Alternative to polling DR_PDR bit to see if the data is available for reading.
+    Async_Sample = &Sample;
+    Async_Done = Done;
+    Async_Sample->Bar_Mode = Bar_Mode;
     
-    temp[0] = 0xFF;  // Prime the while() loop.
+    Async_Buffer[0] = CTRL_REG1;
+    Async_Buffer[1] = MPL_Read_Ctrl(CTRL_REG1) | CTRL_REG1_OST;  // Taken from the shadow copy: the trigger is a single write.
     
-    while((temp[0] & CTRL_REG1_OST) != 0 )  // Poll the DR_TDR pin in DR_STATUS register to see when oversampling is completed and data is available. 
-    {    
-        temp[0] = CTRL_REG1;                     
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,1);
+    Data_Ready = false;
+    Trigger_us = us_ticker_read();
+    Async_State = MPL_ASYNC_TRIGGER;
     
+    if (_i2c.transfer(MPL3115A2_WRITE, Async_Buffer, 2, NULL, 0, event_callback_t(this, &MPL3115A2::MPL_Async_Triggered), I2C_EVENT_ALL) != 0)
+    {
+        Async_State = MPL_ASYNC_IDLE;  // Bus is busy with another transfer.
+        return false;
     }
     
-        temp[0] = OUT_T_MSB;                        // Start the Temperature reading 
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,2);
-        
-        // Now we will reassemble the whole.fractional return value from 2 8-bit portions.
-        // Temperature data: 12-bit signed in degrees C. First 8 bits {OUT_T_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_T_LSB[7:4] is Fractional(unsigned)
+    return true;
+}
+
+bool MPL3115A2::MPL_Sample_Busy()  // 'true' while an asynchronous sample is in progress.
+{
+    return (Async_State != MPL_ASYNC_IDLE);
+}
+
+void MPL3115A2::MPL_Async_Triggered(int Event)  // OST write completed. Wait for the conversion.
+{
+    if ((Event & I2C_EVENT_TRANSFER_COMPLETE) == 0)
+    {
+        MPL_Async_Finish(false);
+        return;
+    }
     
-    int temp_Whole = temp[0];  // Assemble 8-bit Whole segment to determine the sign next.
+    Async_State = MPL_ASYNC_CONVERT;
     
-    int MSB = temp_Whole >> 7;                           // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x0000007F;                // Mask to retain 7 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's to turn into negative 2's comp rep.
-      {
-          temp_Whole = (temp_Whole | 0xFFFFFF80 );       // 32-bit. Pad with '1's all the way to MSB
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
+    if (Data_Ready_Mode == true)  // MPL_Data_Ready_ISR() continues the chain. The timeout is only a safety net for a missed edge.
+    {
+        if (Data_Ready == true)
+        {
+            MPL_Async_Converted();
+            return;
+        }
+        
+        Async_Timer.attach_us(this, &MPL3115A2::MPL_Async_Converted, 2 * MPL_Conversion_Time_us());
+    }
     
-    double temp_Fraction = 0.0625 * (double)((temp[1] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 C. i.e. 1111 is 0.0625*15 = 0.9375 C.
+    else
+    {
+        Async_Timer.attach_us(this, &MPL3115A2::MPL_Async_Converted, MPL_Conversion_Time_us());
+    }
+}
+
+void MPL3115A2::MPL_Async_Converted()  // Conversion time elapsed (or Data Ready interrupt). Check OST and read.
+{
+    if (Async_State != MPL_ASYNC_CONVERT)  // The timeout and the Data Ready interrupt may both fire. Only the first one counts.
+    {
+        return;
+    }
     
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
+    if (Data_Ready == true)  // The interrupt already confirmed the data, skip the OST check.
+    {
+        Async_State = MPL_ASYNC_READ;
+        Async_Buffer[0] = OUT_P_MSB;
+        
+        if (_i2c.transfer(MPL3115A2_WRITE, Async_Buffer, 1, Async_Sample->Raw, 5, event_callback_t(this, &MPL3115A2::MPL_Async_Read), I2C_EVENT_ALL) != 0)
         {
-            return (temp_Whole_dbl - temp_Fraction);
+            MPL_Async_Finish(false);
         }
+        
+        return;
+    }
     
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }   
+    Async_State = MPL_ASYNC_CHECK;
+    Async_Buffer[0] = CTRL_REG1;
+    
+    if (_i2c.transfer(MPL3115A2_WRITE, Async_Buffer, 1, &Async_Buffer[1], 1, event_callback_t(this, &MPL3115A2::MPL_Async_Checked), I2C_EVENT_ALL) != 0)
+    {
+        MPL_Async_Finish(false);
+    }
 }
 
-double MPL3115A2::MPL_Get_Pressure_Change()     // Returns the Atmospheric Pressure deifference from the last reading.
+void MPL3115A2::MPL_Async_Checked(int Event)  // CTRL_REG1 read completed. Read the sample or wait a bit longer.
 {
-    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
+    if ((Event & I2C_EVENT_TRANSFER_COMPLETE) == 0)
+    {
+        MPL_Async_Finish(false);
+        return;
+    }
+    
+    if ((Async_Buffer[1] & CTRL_REG1_OST) != 0)  // Conversion is not over yet.
+    {
+        Async_State = MPL_ASYNC_CONVERT;
+        Async_Timer.attach_us(this, &MPL3115A2::MPL_Async_Converted, MPL_CONVERSION_RETRY_US);
+        return;
+    }
     
-    temp[0] = 0x00;  // Prime the while() loop.
-         
-    if (Bar_Mode == true)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
+    Async_State = MPL_ASYNC_READ;
+    Async_Buffer[0] = OUT_P_MSB;
+    
+    if (_i2c.transfer(MPL3115A2_WRITE, Async_Buffer, 1, Async_Sample->Raw, 5, event_callback_t(this, &MPL3115A2::MPL_Async_Read), I2C_EVENT_ALL) != 0)
+    {
+        MPL_Async_Finish(false);
+    }
+}
+
+void MPL3115A2::MPL_Async_Read(int Event)  // Burst read completed. Decode and report.
+{
+    if ((Event & I2C_EVENT_TRANSFER_COMPLETE) == 0)
     {
-        temp[0] = OUT_P_DELTA_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
+        MPL_Async_Finish(false);
+        return;
+    }
+    
+    MPL_Decode_Sample(*Async_Sample);
+    Async_Sample->Timestamp_us = MPL_Sample_Time_us();   // From the shadow copies and the interrupt time: no I2C traffic in the interrupt context.
+    MPL_Async_Finish(true);
+}
+
+void MPL3115A2::MPL_Async_Finish(bool Success)
+{
+    Async_Timer.detach();
+    Async_State = MPL_ASYNC_IDLE;  // Released before the callback so that Done() may start the next sample.
     
+    if (Async_Done)
+    {
+        Async_Done(Success);
     }
+}
+#endif
+
+bool MPL3115A2::MPL_Wait_For_Conversion()  // Sleeps for the nominal conversion time of the current oversampling ratio, then confirms completion. Returns 'false' on timeout.
+{
+    char temp[1];
     
-    else
+    if ((MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_SBYB) != 0)  // ACTIVE mode: nothing was triggered. Wait for the next periodic sample only when the interrupt tells us about it.
     {
-        MPL_Barometer_Mode();   //Change tto the Barometer Mode.
-        
-        temp[0] = OUT_P_DELTA_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
+        if (Data_Ready_Mode == true)
+        {
+            uint32_t Step_s = 1UL << (MPL_Read_Ctrl(CTRL_REG2) & CTRL_REG2_ST);  // The next sample is at most one time step away.
+            
+            if (Sleeper.Sleep(&Data_Ready, (Step_s <= 2048) ? (MPL_CONVERSION_TIMEOUT * Step_s * 1000000UL) : 0) == false)  // Steps beyond the 32-bit ticker range wait without a timeout.
+            {
+                return false;
+            }
+            
+            Data_Ready = false;  // Consumed. The following data read releases the interrupt pad for the next sample.
+        }
         
+        return true;
     }
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Pressure data: 20-bit signed in Pa. First 18 bits {OUT_P_DELTA_MSB[7:0],OUT_P_DELTA_CSB[7:0],OUT_P_DELTA_LSB[7:6]} is Whole and OUT_P_DELTA_LSB[5:4] Fractional.
+    uint32_t Conversion_us = MPL_Conversion_Time_us();   // From the shadow copy of CTRL_REG1, no I2C traffic.
     
-    int temp_Whole = ( (temp[0] << 10) | (temp[1] << 2) | (temp[2] >> 6) );  // Assemble 18-bit Whole segment
+    if (Data_Ready_Mode == true)  // Interrupt-driven path: the bus stays free for the whole conversion window.
+    {
+        return Sleeper.Sleep(&Data_Ready, MPL_CONVERSION_TIMEOUT * Conversion_us);  // Data_Ready is raised by MPL_Data_Ready_ISR().
+    }
     
-    int MSB = temp_Whole >> 17;                                 // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x0001FFFF;                       // Mask to retain 17 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's.
-      {
-          temp_Whole = (temp_Whole | 0xFFFE0000 );       // 32-bit padding with '1's
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);        // typecast to double after all is set with signs
+    Timer Elapsed;
+    Elapsed.start();
     
-    double temp_Fraction = 0.25 * (double)((temp[2] >> 4) & 0x03);   // right-shift bits 5:4 and isolate. Fractional values are in increments of 0.25 Pa. i.e. 11 is 0.25*3 = 0.75 Pa. 10 is 0.25*2, and 01 is 0.25*1.
+    Sleeper.Sleep(NULL, Conversion_us);  // No point asking before the nominal conversion time: the bus stays quiet and the core sleeps.
     
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
+    while (true)  // Normally a single check. A few more if the conversion runs late, bounded by the timeout.
+    {
+        temp[0] = CTRL_REG1;                     
+        MPL_Bus_Write(temp,1,true);
+        MPL_Bus_Read(temp,1);
+        
+        if ((temp[0] & CTRL_REG1_OST) == 0)  // OST auto-clears once the acquisition is completed.
         {
-            return (temp_Whole_dbl - temp_Fraction);
+            return true;
         }
-    
-    else                      // if whole is positive, we add the fractional part as usual.      
+        
+        if (Elapsed.read_us() >= (int)(MPL_CONVERSION_TIMEOUT * Conversion_us))
         {
-            return (temp_Whole_dbl + temp_Fraction);
+            return false;
         }
+        
+        Sleeper.Sleep(NULL, MPL_CONVERSION_RETRY_US);
+    }
 }
 
-double MPL3115A2::MPL_Get_Altitude_Change()     // Returns the Altitude reading.
+void MPL3115A2::MPL_Decode_Sample(MPL_Sample &Sample)  // Reassembles Pressure/Altitude and Temperature from the Raw bytes of the sample. Integer decode first, doubles derived from it.
 {
-    char temp[3];  // Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
+    Sample.Pressure_Fixed = 0;
+    Sample.Altitude_Fixed = 0;
     
-    if (Bar_Mode == false)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
+    if (Sample.Bar_Mode == true)
     {
-        temp[0] = OUT_P_DELTA_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-    
+        Sample.Pressure_Fixed = MPL_Decode_Pressure(&Sample.Raw[0]);
+        Sample.Altitude_Fixed = MPL_Altitude_From_Pressure(Altitude_Reference, Sample.Pressure_Fixed);  // Both quantities from one conversion. Integer only, safe in the interrupt context.
     }
     
     else
     {
-        MPL_Altimeter_Mode();   // Change to the Altimeter Mode.
-        
-        temp[0] = OUT_P_DELTA_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-        
+        Sample.Altitude_Fixed = MPL_Decode_Altitude(&Sample.Raw[0]);
     }
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Altitude data: 20-bit unsigned in m. First 16 bits {OUT_P_DELTA_MSB[7:0],OUT_P_DELTA_CSB[7:0]}(signed, 2's comp.) is Whole and OUT_P_DELTA_LSB[7:4] is Fractional(unsigned)
-    
-    int temp_Whole = ( (temp[0] << 8) | temp[1] );  // Assemble 16-bit Whole segment to determine the sign next.
+    Sample.Temperature_Fixed = MPL_Decode_Temperature(&Sample.Raw[3]);
     
-    int MSB = temp_Whole >> 15;                                 // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x00007FFF;                              // Mask to retain 15 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's.
-      {
-          temp_Whole = (temp_Whole | 0xFFFF8000 );   // 32-bit
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
+    Sample.Pressure = 0.25 * (double)Sample.Pressure_Fixed;
+    Sample.Altitude = 0.0625 * (double)Sample.Altitude_Fixed;
+    Sample.Temperature = 0.0625 * (double)Sample.Temperature_Fixed;
+}
+
+int32_t MPL3115A2::MPL_Get_Pressure_Change_Fixed()     // Returns the Atmospheric Pressure difference from the last reading. Q18.2 Pa
+{
+    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    double temp_Fraction = 0.0625 * (double)((temp[2] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 m. i.e. 1111 is 0.0625*15 = 0.9375 m.
+    if (Bar_Mode == false)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
+    {
+        MPL_Barometer_Mode();   //Change to the Barometer Mode.
+    }
     
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
+    temp[0] = OUT_P_DELTA_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }
+    return MPL_Decode_Pressure_Change(temp);  // Integer reassembly, see MPL3115A2_Decode.h
 }
 
-double MPL3115A2::MPL_Get_Temperature_Change()  // Returns Teperature reading.
+double MPL3115A2::MPL_Get_Pressure_Change()     // Returns the Atmospheric Pressure difference from the last reading.
 {
-    char temp[3];  //Dummy array to store Outgoing and incomming bytes. Cleared after the function returns. 
-    
-    temp[0] = 0x00;  // Prime the while() loop.
+    return 0.25 * (double)MPL_Get_Pressure_Change_Fixed();
+}
 
-        temp[0] = OUT_T_DELTA_MSB;                        // Start the Temperature reading 
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,2);
-        
-        // Now we will reassemble the whole.fractional return value from 2 8-bit portions.
-        // Temperature data: 12-bit unsigned in degrees C. First 8 bits {OUT_T_DELTA_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_T_DELTA_LSB[7:4] is Fractional(unsigned)
+int32_t MPL3115A2::MPL_Get_Altitude_Change_Fixed()     // Returns the Altitude difference from the last reading. Q16.4 m
+{
+    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    int temp_Whole = temp[0];  // Assemble 8-bit Whole segment to determine the sign next.
+    if (Bar_Mode == true)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
+    {
+        MPL_Altimeter_Mode();   //Change to the Altimeter Mode.
+    }
     
-    int MSB = temp_Whole >> 7;                           // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x0000007F;                // Mask to retain 7 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's to turn into negative 2's comp rep.
-      {
-          temp_Whole = (temp_Whole | 0xFFFFFF80 );       // 32-bit. Pad with '1's all the way to MSB
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
+    temp[0] = OUT_P_DELTA_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    double temp_Fraction = 0.0625 * (double)((temp[1] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 C. i.e. 1111 is 0.0625*15 = 0.9375 C.
+    return MPL_Decode_Altitude(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Altitude_Change()     // Returns the Altitude difference from the last reading.
+{
+    return 0.0625 * (double)MPL_Get_Altitude_Change_Fixed();
+}
+
+int32_t MPL3115A2::MPL_Get_Temperature_Change_Fixed()     // Returns the Temperature difference from the last reading. Q8.4 C
+{
+    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
+    temp[0] = OUT_T_DELTA_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,2);
     
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }
+    return MPL_Decode_Temperature(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Temperature_Change()     // Returns the Temperature difference from the last reading.
+{
+    return 0.0625 * (double)MPL_Get_Temperature_Change_Fixed();
 }
 
 void MPL3115A2::MPL_Trim_Pressure(int16_t P_Trim)  // Pressure Trimming [-512,508] Pa. 4Pa per LSB
@@ -358,7 +542,7 @@ void MPL3115A2::MPL_Trim_Pressure(int16_t P_Trim)  // Pressure Trimming [-512,50
         temp[0] = OFF_P;        // OFF_P register address
         temp[1] = P_Trim_In;    // Value to be written for Pressure offset
         
-        _i2c.write(MPL3115A2_WRITE, temp, 2);
+        MPL_Write_Registers(temp, 2);
     
 }
 
@@ -380,7 +564,13 @@ void MPL3115A2::MPL_Trim_Altitude(int8_t A_Trim)  // Altitude Trimming [-128,127
         temp[0] = OFF_H;        // OFF_H register address
         temp[1] = A_Trim;    // Value to be written for Altitude offset
         
-        _i2c.write(MPL3115A2_WRITE, temp, 2);
+        MPL_Write_Registers(temp, 2);
+        
+        if (Batching == false)   // Staged: MPL_Flush() applies the trim when the device gets it.
+        {
+            Altitude_Trim = A_Trim;   // The software altitude applies the same offset.
+            MPL_Altitude_Set_Reference(Altitude_Reference, Bar_Reference_Pa, Altitude_Trim);
+        }
 }
 
 void MPL3115A2::MPL_Trim_Temperature(double T_Trim)  // Temperature trim [-8, 7.9375] degrees C. 0.0625 C per LSB.
@@ -402,7 +592,7 @@ void MPL3115A2::MPL_Trim_Temperature(double T_Trim)  // Temperature trim [-8, 7.
   temp[0] = OFF_T;        // OFF_T register address
   temp[1] = Trim_T_In;    // Value to be written for Temperature offset
         
-  _i2c.write(MPL3115A2_WRITE, temp, 2);
+  MPL_Write_Registers(temp, 2);
   
 }
 
@@ -412,8 +602,8 @@ bool MPL3115A2::MPL_is_Active()  // Returns the status whether the device in Act
     
     temp[0] = CTRL_REG1;        // CTRL_REG1 register address
     
-    _i2c.write(MPL3115A2_WRITE, temp,1,true);
-    _i2c.read(MPL3115A2_READ, temp,1);
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
     
     if((temp[0] & CTRL_REG1_SBYB) != 0)
         {
@@ -441,8 +631,13 @@ void MPL3115A2::MPL_Set_Barometric_Reference(uint32_t Bar_Reference)  // Atmosph
     temp[1] = MSB;
     temp[2] = LSB;
     
-    _i2c.write(MPL3115A2_WRITE, temp,3);
+    MPL_Write_Registers(temp, 3);
     
+    if (Batching == false)   // Staged: MPL_Flush() applies the reference when the device gets it.
+    {
+        Bar_Reference_Pa = (uint32_t)Bar_Reference_In * 2;   // What the device actually uses, 2 Pa resolution.
+        MPL_Altitude_Set_Reference(Altitude_Reference, Bar_Reference_Pa, Altitude_Trim);
+    }
 }
 
 uint32_t MPL3115A2::MPL_Get_Barometric_Reference()
@@ -450,14 +645,29 @@ uint32_t MPL3115A2::MPL_Get_Barometric_Reference()
     char temp[3]; 
     
     temp[0] = BAR_IN_MSB;
-    _i2c.write(MPL3115A2_WRITE, temp,1, true);
-    _i2c.read(MPL3115A2_READ, temp,2);
+    MPL_Bus_Write(temp,1, true);
+    MPL_Bus_Read(temp,2);
     
    uint16_t Pressure_Reference = (( temp[0] << 8) | temp[1] );  // Assemble 16-bit unsigned value  from 2 8-bit register segments. 
    
    return (Pressure_Reference * 2);  // Return 2*value because register value is 2 times smaller of the actual. 
 }
 
+int32_t MPL3115A2::MPL_Altitude_From_Pressure_Fixed(int32_t Pressure_Fixed)  // Q18.2 Pa -> Q16.4 m with the same BAR_IN reference and OFF_H trim as the device.
+{
+    if (Shadow_Valid == false)   // BAR_IN and OFF_H are loaded together with the control registers.
+    {
+        MPL_Sync_Control_Registers();
+    }
+    
+    return MPL_Altitude_From_Pressure(Altitude_Reference, Pressure_Fixed);
+}
+
+void MPL3115A2::MPL_Set_Software_Altitude(bool Enable)  // 'true' - MPL_Get_Altitude() stays in Barometer mode and computes Altitude from Pressure.
+{
+    Software_Altitude = Enable;
+}
+
 void MPL3115A2::MPL_Set_Pressure_Target(uint32_t P_Target)  //  Target Pressure for interrupts/alarms. Units: Pascals
 {
     char temp[3]; 
@@ -474,7 +684,7 @@ void MPL3115A2::MPL_Set_Pressure_Target(uint32_t P_Target)  //  Target Pressure
     temp[1] = MSB;
     temp[2] = LSB;
     
-    _i2c.write(MPL3115A2_WRITE, temp,3);
+    MPL_Write_Registers(temp, 3);
 }
 
 void MPL3115A2::MPL_Set_Altitude_Target(int16_t A_Target)   //  Target Altitude for interrupts/alarms. Units: meters
@@ -492,7 +702,7 @@ void MPL3115A2::MPL_Set_Altitude_Target(int16_t A_Target)   //  Target Altitude
     temp[1] = MSB;
     temp[2] = LSB;
     
-    _i2c.write(MPL3115A2_WRITE, temp,3);
+    MPL_Write_Registers(temp, 3);
 }
 
 void MPL3115A2::MPL_Set_Temperature_Target(int8_t T_Target) //  Target Temperature for interrupts/alarms. Units: Degrees C
@@ -505,7 +715,7 @@ void MPL3115A2::MPL_Set_Temperature_Target(int8_t T_Target) //  Target Temperatu
     temp[0] = T_TGT;        // P_TGT_MSB register address
     temp[1] = T_Target;
      
-    _i2c.write(MPL3115A2_WRITE, temp,2);
+    MPL_Write_Registers(temp, 2);
     
 }
 
@@ -513,10 +723,7 @@ void MPL3115A2::MPL_Set_Pressure_Window(uint32_t P_Window)  //  Window for Press
 {
     // Obtain the current value from the Pressure Target Register. Will be used to set safe operational windows not to exceed min/max operational values. 
     char temp[3]; 
-    temp[0] = P_TGT_MSB;        // P_TGT_MSB register address
-    
-    _i2c.write(MPL3115A2_WRITE, temp,1, true);
-    _i2c.read(MPL3115A2_READ, temp,2);
+    MPL_Read_Registers(P_TGT_MSB, temp, 2);  // Staged value when the target is part of the same batch.
     
     uint32_t Current_Target = ( (temp[0] << 8 | temp[1]) & 0x0000FFFF ) * 2; // Reconstruct the Target value. Note: Target register contains value in 2Pa increments -> post-multiply by 2 to geta actual value. 
     
@@ -537,17 +744,14 @@ void MPL3115A2::MPL_Set_Pressure_Window(uint32_t P_Window)  //  Window for Press
     temp[1] = MSB;
     temp[2] = LSB;
     
-    _i2c.write(MPL3115A2_WRITE, temp,3);
+    MPL_Write_Registers(temp, 3);
 
 }
 
 void MPL3115A2::MPL_Set_Altitude_Window(uint16_t A_Window)   //  Window for Altitude for interrupts/alarms. Units: meters
 {
     char temp[3]; 
-    temp[0] = P_TGT_MSB;        // P_TGT_MSB register address
-    
-    _i2c.write(MPL3115A2_WRITE, temp,1, true);
-    _i2c.read(MPL3115A2_READ, temp,2);
+    MPL_Read_Registers(P_TGT_MSB, temp, 2);  // Staged value when the target is part of the same batch.
     
     int16_t Current_Target = ((temp[0] << 8) | temp[1]); // Reconstruct the Target value. Note: Target register contains value in 1 m increments. 
     
@@ -566,16 +770,13 @@ void MPL3115A2::MPL_Set_Altitude_Window(uint16_t A_Window)   //  Window for Alti
     temp[1] = MSB;
     temp[2] = LSB;
     
-    _i2c.write(MPL3115A2_WRITE, temp,3);
+    MPL_Write_Registers(temp, 3);
 }
 
 void MPL3115A2::MPL_Set_Temperature_Window(uint8_t T_Window) //  Window for Temperature for interrupts/alarms. Units: Degrees C
 {
     char temp[2]; 
-    temp[0] = T_TGT;        // T_TGT register address
-    
-    _i2c.write(MPL3115A2_WRITE, temp,1, true);
-    _i2c.read(MPL3115A2_READ, temp,1);
+    MPL_Read_Registers(T_TGT, temp, 1);  // Staged value when the target is part of the same batch.
     
     int8_t Current_Target = temp[0]; // Note: Target register contains value in 1 C increments. 
     
@@ -589,243 +790,93 @@ void MPL3115A2::MPL_Set_Temperature_Window(uint8_t T_Window) //  Window for Temp
     temp[0] = T_WND;        // T_WND register address
     temp[1] = T_Window;
     
-    _i2c.write(MPL3115A2_WRITE,temp,2);
+    MPL_Write_Registers(temp, 2);
 }
 
 double MPL3115A2::MPL_Get_Min_Pressure()  // Obtain the lowest recorded Pressure since the last reset
 {
     char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
-     
-    if (Bar_Mode == true)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
-    {
-        temp[0] = P_MIN_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-    }
     
-    else
+    if (Bar_Mode == false)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
     {
         MPL_Barometer_Mode();   //Change to the Barometer Mode.
-        
-        temp[0] = P_MIN_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);     
     }
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Pressure data: 20-bit unsigned in Pa. First 18 bits {OUT_P_MSB[7:0],OUT_C_MSB[7:0],OUT_P_LSB[7:6]} is Whole and OUT_P_LSB[5:4] Fractional.
-    
-    double temp_Whole = (double)( (temp[0] << 10) | (temp[1] << 2) | (temp[2] >> 6) );  // Assemble 18-bit Whole segment
-    
-    double temp_Fraction = 0.25 * (double)((temp[2] >> 4) & 0x03);   // right-shift bits 5:4 and isolate. Fractional values are in increments of 0.25 Pa. i.e. 11 is 0.25*3 = 0.75 Pa. 10 is 0.25*2, and 01 is 0.25*1.
+    temp[0] = P_MIN_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    return (temp_Whole + temp_Fraction);
+    return 0.25 * (double)MPL_Decode_Pressure(temp);  // Integer reassembly, see MPL3115A2_Decode.h
 }
 
 double MPL3115A2::MPL_Get_Max_Pressure()  // Obtain the highest recorded Pressure since the last reset
 {
     char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
-     
-    if (Bar_Mode == true)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
-    {
-        temp[0] = P_MAX_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-    }
     
-    else
+    if (Bar_Mode == false)   // Verify that the device is in Barometer mode so we do return Pressure from the register.
     {
         MPL_Barometer_Mode();   //Change to the Barometer Mode.
-        
-        temp[0] = P_MAX_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);     
     }
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Pressure data: 20-bit unsigned in Pa. First 18 bits {OUT_P_MSB[7:0],OUT_C_MSB[7:0],OUT_P_LSB[7:6]} is Whole and OUT_P_LSB[5:4] Fractional.
-    
-    double temp_Whole = (double)( (temp[0] << 10) | (temp[1] << 2) | (temp[2] >> 6) );  // Assemble 18-bit Whole segment
-    
-    double temp_Fraction = 0.25 * (double)((temp[2] >> 4) & 0x03);   // right-shift bits 5:4 and isolate. Fractional values are in increments of 0.25 Pa. i.e. 11 is 0.25*3 = 0.75 Pa. 10 is 0.25*2, and 01 is 0.25*1.
+    temp[0] = P_MAX_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    return (temp_Whole + temp_Fraction);
+    return 0.25 * (double)MPL_Decode_Pressure(temp);  // Integer reassembly, see MPL3115A2_Decode.h
 }
 
-double MPL3115A2::MPL_Get_Min_Altitude()  // Obtain the lowest recorded Altitude since thelast reset
+double MPL3115A2::MPL_Get_Min_Altitude()  // Obtain the lowest recorded Altitude since the last reset
 {
     char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    if (Bar_Mode == false)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
+    if (Bar_Mode == true)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
     {
-        temp[0] = P_MIN_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3); 
+        MPL_Altimeter_Mode();   //Change to the Altimeter Mode.
     }
     
-    else
-    {
-        MPL_Altimeter_Mode();   //Change to the Barometer Mode.
-        
-        temp[0] = P_MIN_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-        
-    }
+    temp[0] = P_MIN_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Altitude data: 20-bit unsigned in m. First 16 bits {OUT_P_MSB[7:0],OUT_C_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_P_LSB[7:4] is Fractional(unsigned)
+    return 0.0625 * (double)MPL_Decode_Altitude(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Max_Altitude()  // Obtain the highest recorded Altitude since the last reset
+{
+    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    int temp_Whole = ( (temp[0] << 8) | temp[1] );  // Assemble 16-bit Whole segment to determine the sign next.
+    if (Bar_Mode == true)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
+    {
+        MPL_Altimeter_Mode();   //Change to the Altimeter Mode.
+    }
     
-    int MSB = temp_Whole >> 15;                                 // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x00007FFF;                              // Mask to retain 15 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's.
-      {
-          temp_Whole = (temp_Whole | 0xFFFF8000 );   // 32-bit
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
+    temp[0] = P_MAX_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,3);
     
-    double temp_Fraction = 0.0625 * (double)((temp[2] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 m. i.e. 1111 is 0.0625*15 = 0.9375 m.
+    return 0.0625 * (double)MPL_Decode_Altitude(temp);  // Integer reassembly, see MPL3115A2_Decode.h
+}
+
+double MPL3115A2::MPL_Get_Min_Temperature()  // Obtain the lowest recorded Temperature since the last reset
+{
+    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
+    temp[0] = T_MIN_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,2);
     
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }
+    return 0.0625 * (double)MPL_Decode_Temperature(temp);  // Integer reassembly, see MPL3115A2_Decode.h
 }
 
-double MPL3115A2::MPL_Get_Max_Altitude()  // Obtain the highest recorded Altitude since thelast reset
+double MPL3115A2::MPL_Get_Max_Temperature()  // Obtain the highest recorded Temperature since the last reset
 {
     char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
     
-    if (Bar_Mode == false)   // Verify that the device is in Altimeter mode so we do return Altitude from the register.
-    {
-        temp[0] = P_MAX_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3); 
-    }
-    
-    else
-    {
-        MPL_Altimeter_Mode();   //Change to the Barometer Mode.
-        
-        temp[0] = P_MAX_MSB;
-        _i2c.write(MPL3115A2_WRITE,temp,1,true);
-        _i2c.read(MPL3115A2_READ,temp,3);
-        
-    }
-    
-    // Now we will reassemble the whole.fractional return value from 3 8-bit portions.
-    // Altitude data: 20-bit unsigned in m. First 16 bits {OUT_P_MSB[7:0],OUT_C_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_P_LSB[7:4] is Fractional(unsigned)
-    
-    int temp_Whole = ( (temp[0] << 8) | temp[1] );  // Assemble 16-bit Whole segment to determine the sign next.
-    
-    int MSB = temp_Whole >> 15;                                 // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x00007FFF;                              // Mask to retain 15 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's.
-      {
-          temp_Whole = (temp_Whole | 0xFFFF8000 );   // 32-bit
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
-    
-    double temp_Fraction = 0.0625 * (double)((temp[2] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 m. i.e. 1111 is 0.0625*15 = 0.9375 m.
-    
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
-    
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }
-}
-
-double MPL3115A2::MPL_Get_Min_Temperature()  // Obtain the lowest recorded Temperature since thelast reset
-{
-    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
-
-
-    temp[0] = T_MIN_MSB;                        // Start the Min Temperature reading 
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,2);
-        
-        // Now we will reassemble the whole.fractional return value from 2 8-bit portions.
-        // Temperature data: 12-bit signed in degrees C. First 8 bits {OUT_T_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_T_LSB[7:4] is Fractional(unsigned)
-    
-    int temp_Whole = temp[0];  // Assemble 8-bit Whole segment to determine the sign next.
-    
-    int MSB = temp_Whole >> 7;                           // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x0000007F;                // Mask to retain 7 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's to turn into negative 2's comp rep.
-      {
-          temp_Whole = (temp_Whole | 0xFFFFFF80 );       // 32-bit. Pad with '1's all the way to MSB
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
-    
-    double temp_Fraction = 0.0625 * (double)((temp[1] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 C. i.e. 1111 is 0.0625*15 = 0.9375 C.
-    
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
-    
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }   
-}
-
-double MPL3115A2::MPL_Get_Max_Temperature()  // Obtain the highest recorded Temperature since the last reset
-{
-    char temp[3];  //Dummy array to store Outgoiing and incomming bytes. Cleared after the function returns. 
-
-
-    temp[0] = T_MAX_MSB;                     // Start the Min Temperature reading 
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,2);
-        
-        // Now we will reassemble the whole.fractional return value from 2 8-bit portions.
-        // Temperature data: 12-bit signed in degrees C. First 8 bits {OUT_T_MSB[7:0]}(signed, 2's comp.) is Whole and OUT_T_LSB[7:4] is Fractional(unsigned)
-    
-    int temp_Whole = temp[0];  // Assemble 8-bit Whole segment to determine the sign next.
-    
-    int MSB = temp_Whole >> 7;                           // Extract the sign of of 2's complement value
-      
-    temp_Whole = temp_Whole & 0x0000007F;                // Mask to retain 7 non-sign bits
-      
-    if(MSB == 1)                                         // If extracted sign is negative pad 15-bit with 1's to turn into negative 2's comp rep.
-      {
-          temp_Whole = (temp_Whole | 0xFFFFFF80 );       // 32-bit. Pad with '1's all the way to MSB
-      }
-      
-    double temp_Whole_dbl = (double)(temp_Whole);
-    
-    double temp_Fraction = 0.0625 * (double)((temp[1] >> 4) & 0x0F);   // right-shift bits 7:4 and isolate. Fractional values are in increments of 0.0625 C. i.e. 1111 is 0.0625*15 = 0.9375 C.
-    
-    if (temp_Whole_dbl < 0)   // if whole is negative, we substract the fractional part: i.e. -100.25 is -100 - 0.25 
-        {
-            return (temp_Whole_dbl - temp_Fraction);
-        }
+    temp[0] = T_MAX_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,2);
     
-    else                      // if whole is positive, we add the fractional part as usual.      
-        {
-            return (temp_Whole_dbl + temp_Fraction);
-        }   
+    return 0.0625 * (double)MPL_Decode_Temperature(temp);  // Integer reassembly, see MPL3115A2_Decode.h
 }
 
 void MPL3115A2::MPL_Reset_Min_P_A()  // Reset the Lowest recorded Pressure/Altitude
@@ -838,7 +889,7 @@ void MPL3115A2::MPL_Reset_Min_P_A()  // Reset the Lowest recorded Pressure/Altit
     temp[2] = 0x00;
     temp[3] = 0x00;
     
-    _i2c.write(MPL3115A2_WRITE,temp,4);
+    MPL_Bus_Write(temp,4);
 }
 
 void MPL3115A2::MPL_Reset_Max_P_A()  // Reset the Highest recorded Pressure/Altitude
@@ -851,7 +902,7 @@ void MPL3115A2::MPL_Reset_Max_P_A()  // Reset the Highest recorded Pressure/Alti
     temp[2] = 0x00;
     temp[3] = 0x00;
     
-    _i2c.write(MPL3115A2_WRITE,temp,4);
+    MPL_Bus_Write(temp,4);
 }
 
 void MPL3115A2::MPL_Reset_Min_T()  // Reset the Lowest recorded Temperature
@@ -863,7 +914,7 @@ void MPL3115A2::MPL_Reset_Min_T()  // Reset the Lowest recorded Temperature
     temp[1] = 0x00;
     temp[2] = 0x00;
     
-    _i2c.write(MPL3115A2_WRITE,temp,3);
+    MPL_Bus_Write(temp,3);
 }
 
 void MPL3115A2::MPL_Reset_Max_T()  // Reset the Highest recorded Temperature
@@ -875,22 +926,173 @@ void MPL3115A2::MPL_Reset_Max_T()  // Reset the Highest recorded Temperature
     temp[1] = 0x00;
     temp[2] = 0x00;
     
-    _i2c.write(MPL3115A2_WRITE,temp,3);
+    MPL_Bus_Write(temp,3);
+}
+
+void MPL3115A2::MPL_Get_Extremes(MPL_Extremes &Extremes, bool Reset)  // All six min/max values from one 10-byte burst read, optionally cleared right after.
+{
+    char temp[11];
+    
+    temp[0] = P_MIN_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(Extremes.Raw,10);   // Auto-increment: P_MIN_MSB..P_MIN_LSB, T_MIN_MSB, T_MIN_LSB, P_MAX_MSB..P_MAX_LSB, T_MAX_MSB, T_MAX_LSB
+    
+    if (Reset == true)  // Issued back-to-back with the read: only an acquisition completing in between (one I2C write) escapes both the snapshot and the new extremes.
+    {
+        memset(&temp[1], 0x00, 10);  // To clear we write '0' to the registers.
+        MPL_Bus_Write(temp,11);
+    }
+    
+    Extremes.Bar_Mode = Bar_Mode;
+    Extremes.Min_Pressure_Fixed = 0;
+    Extremes.Max_Pressure_Fixed = 0;
+    
+    if (Bar_Mode == true)
+    {
+        Extremes.Min_Pressure_Fixed = MPL_Decode_Pressure(&Extremes.Raw[0]);
+        Extremes.Max_Pressure_Fixed = MPL_Decode_Pressure(&Extremes.Raw[5]);
+        Extremes.Min_Altitude_Fixed = MPL_Altitude_From_Pressure(Altitude_Reference, Extremes.Max_Pressure_Fixed);  // Altitude falls as pressure rises.
+        Extremes.Max_Altitude_Fixed = MPL_Altitude_From_Pressure(Altitude_Reference, Extremes.Min_Pressure_Fixed);
+    }
+    
+    else
+    {
+        Extremes.Min_Altitude_Fixed = MPL_Decode_Altitude(&Extremes.Raw[0]);
+        Extremes.Max_Altitude_Fixed = MPL_Decode_Altitude(&Extremes.Raw[5]);
+    }
+    
+    Extremes.Min_Temperature_Fixed = MPL_Decode_Temperature(&Extremes.Raw[3]);
+    Extremes.Max_Temperature_Fixed = MPL_Decode_Temperature(&Extremes.Raw[8]);
+    
+    Extremes.Min_Pressure = 0.25 * (double)Extremes.Min_Pressure_Fixed;
+    Extremes.Max_Pressure = 0.25 * (double)Extremes.Max_Pressure_Fixed;
+    Extremes.Min_Altitude = 0.0625 * (double)Extremes.Min_Altitude_Fixed;
+    Extremes.Max_Altitude = 0.0625 * (double)Extremes.Max_Altitude_Fixed;
+    Extremes.Min_Temperature = 0.0625 * (double)Extremes.Min_Temperature_Fixed;
+    Extremes.Max_Temperature = 0.0625 * (double)Extremes.Max_Temperature_Fixed;
+}
+
+void MPL3115A2::MPL_Start_Continuous(uint16_t Period)  // Switch to ACTIVE mode: the sensor samples on its own timer every Period seconds, rounded up to 2^n.
+{
+    char Time_Step = 0;
+    
+    while ((Time_Step < CTRL_REG2_ST) && ((1UL << Time_Step) < Period))  // Smallest ST with 2^ST >= Period.
+    {
+        Time_Step++;
+    }
+    
+    char temp_Reg1 = MPL_Read_Ctrl(CTRL_REG1);
+    
+    if ((temp_Reg1 & CTRL_REG1_SBYB) != 0)  // The time step must be changed in STANDBY.
+    {
+        temp_Reg1 &= ~CTRL_REG1_SBYB;
+        MPL_Write_Ctrl(CTRL_REG1, temp_Reg1);
+    }
+    
+    MPL_Write_Ctrl(CTRL_REG2, (MPL_Read_Ctrl(CTRL_REG2) & ~CTRL_REG2_ST) | Time_Step);
+    
+    Data_Ready = false;
+    
+    MPL_Write_Ctrl(CTRL_REG1, temp_Reg1 | CTRL_REG1_SBYB);
+    
+    Active_us = us_ticker_read();   // The sensor timer starts with the end of the write: sample n lands at Active_us + conversion time + n time steps.
+    Active_Known = true;
+}
+
+void MPL3115A2::MPL_Stop_Continuous()  // Return to STANDBY (one-shot) mode.
+{
+    MPL_Write_Ctrl(CTRL_REG1, MPL_Read_Ctrl(CTRL_REG1) & ~CTRL_REG1_SBYB);
+}
+
+bool MPL3115A2::MPL_Read_Latest_Sample(MPL_Sample &Sample)  // Read STATUS..OUT_T_LSB in one 6-byte burst. Returns 'true' if the sample is new since the last read.
+{
+    char temp[6];
+    
+    temp[0] = STATUS;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,6);   // Auto-increment: STATUS, OUT_P_MSB, OUT_P_CSB, OUT_P_LSB, OUT_T_MSB, OUT_T_LSB
+    
+    for (int i = 0; i < 5; i++)
+    {
+        Sample.Raw[i] = temp[i + 1];
+    }
+    
+    Sample.Bar_Mode = Bar_Mode;
+    
+    MPL_Decode_Sample(Sample);
+    
+    Sample.Timestamp_us = MPL_Sample_Time_us();
+    
+    return ((temp[0] & DR_PTDR) != 0);   // Reading OUT_P_MSB/OUT_T_MSB clears the flag until the next acquisition.
+}
+
+bool MPL3115A2::MPL_Read_Frame(MPL_Frame &Frame)  // Values, deltas and status of the same acquisition: 0x06..0x0B then 0x00..0x05.
+{
+    for (int Attempt = 0; Attempt < MPL_FRAME_RETRIES; Attempt++)
+    {
+        // 0x00..0x0B cannot be read in one burst: the address pointer wraps from OUT_T_LSB back to STATUS and
+        // from OUT_T_DELTA_LSB back to DR_STATUS. DR_STATUS and the deltas go first, since reading them clears nothing.
+        Frame.Raw[6] = DR_STATUS;
+        MPL_Bus_Write(&Frame.Raw[6],1,true);
+        MPL_Bus_Read(&Frame.Raw[6],6);   // Auto-increment: DR_STATUS, OUT_P_DELTA_MSB..LSB, OUT_T_DELTA_MSB, OUT_T_DELTA_LSB
+        
+        Frame.Raw[0] = STATUS;
+        MPL_Bus_Write(&Frame.Raw[0],1,true);
+        MPL_Bus_Read(&Frame.Raw[0],6);   // Auto-increment: STATUS, OUT_P_MSB..LSB, OUT_T_MSB, OUT_T_LSB. Clears the data-ready flags.
+        
+        if ((Frame.Raw[0] & ~Frame.Raw[6] & MPL_DR_FLAGS) == 0)  // STATUS mirrors DR_STATUS: a flag that appeared between the two bursts means the values are newer than the deltas.
+        {
+            break;
+        }
+    }
+    
+    Frame.Status = Frame.Raw[6];
+    
+    for (int i = 0; i < 5; i++)
+    {
+        Frame.Current.Raw[i] = Frame.Raw[i + 1];
+    }
+    
+    Frame.Current.Bar_Mode = Bar_Mode;
+    MPL_Decode_Sample(Frame.Current);
+    Frame.Current.Timestamp_us = MPL_Sample_Time_us();
+    
+    Frame.Pressure_Change_Fixed = 0;
+    
+    if (Bar_Mode == true)
+    {
+        Frame.Pressure_Change_Fixed = MPL_Decode_Pressure_Change(&Frame.Raw[7]);
+        Frame.Altitude_Change_Fixed = Frame.Current.Altitude_Fixed - MPL_Altitude_From_Pressure(Altitude_Reference, Frame.Current.Pressure_Fixed - Frame.Pressure_Change_Fixed);
+    }
+    
+    else
+    {
+        Frame.Altitude_Change_Fixed = MPL_Decode_Altitude(&Frame.Raw[7]);
+    }
+    
+    Frame.Temperature_Change_Fixed = MPL_Decode_Temperature(&Frame.Raw[10]);
+    
+    Frame.Pressure_Change = 0.25 * (double)Frame.Pressure_Change_Fixed;
+    Frame.Altitude_Change = 0.0625 * (double)Frame.Altitude_Change_Fixed;
+    Frame.Temperature_Change = 0.0625 * (double)Frame.Temperature_Change_Fixed;
+    
+    return ((Frame.Status & DR_PTDR) != 0);
 }
 
 void MPL3115A2::MPL_One_Shot_Measure()  //Initiate one-shot acquisition of Pressure/Altitude and Temperature. Retrieve the data with MPL_Get_...() functions.
 {
-    char temp[2];
+    if ((MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_SBYB) != 0)  // In ACTIVE mode OST would not auto-clear and would disturb the time step. The latest periodic sample is used instead.
+    {
+        return;
+    }
     
-    temp[0] = CTRL_REG1;                        // Read contents of CTRL_REG1 so we can OR our command bit while preserving the previous contents
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
+    char temp_Reg1 = MPL_Read_Ctrl(CTRL_REG1) | CTRL_REG1_OST;  // Makes sure we preserve the previous contents intact. Taken from the shadow copy, no read-back.
     
-    char temp_Reg1 = temp[0] | CTRL_REG1_OST;  // Makes sure we preserve the previous contents intact. 
+    Data_Ready = false;  // Cleared before the trigger so the interrupt of this acquisition cannot be missed.
     
-    temp[0] = CTRL_REG1;
-    temp[1] = temp_Reg1;
-    _i2c.write(MPL3115A2_WRITE,temp,2);
+    MPL_Write_Ctrl(CTRL_REG1, temp_Reg1);
+    
+    Trigger_us = us_ticker_read();   // The conversion starts with the end of the write.
 }
 
 bool MPL3115A2::MPL_System_Reset()  // Software reset of the MPL3115A2 unit. All registers defaulted. I2C is frozen to prevent data corruption.
@@ -903,9 +1105,37 @@ bool MPL3115A2::MPL_System_Reset()  // Software reset of the MPL3115A2 unit. All
         // Initiate Software Reset
         temp[0] = CTRL_REG1;
         temp[1] = CTRL_REG1_RST;
-        _i2c.write(MPL3115A2_WRITE,temp,2);
+        MPL_Bus_Write(temp,2);
     
         is_Reset = true;  // Indicates that the device just undergo the reset. 
+        
+        for (int i = 0; i < 5; i++)  // All control registers default to 0x00 after the reset.
+        {
+            Ctrl_Shadow[i] = 0x00;
+        }
+        
+        Shadow_Valid = true;
+        Bar_Mode = true;  // CTRL_REG1_ALT is cleared by the reset.
+        FIFO_Setup = F_SETUP_F_MODE_DISABLED;
+        Staged_Mask = 0;  // Anything staged before the reset is stale.
+        Batching = false;
+        
+        Bar_Reference_Pa = 101326;  // BAR_IN and OFF_H are defaulted as well.
+        Altitude_Trim = 0;
+        MPL_Altitude_Set_Reference(Altitude_Reference, Bar_Reference_Pa, Altitude_Trim);
+        
+        // CTRL_REG4/CTRL_REG5 are cleared: no interrupt source is enabled any more. Waiting on one would only end on the timeout.
+        Data_Ready_Mode = false;
+        Data_Ready = false;
+        
+        if (Int_Pin != NULL)
+        {
+            Int_Pin->rise(NULL);
+            Int_Pin->fall(NULL);
+        }
+        
+        Low_Power_FIFO = false;   // FIFO disabled, STANDBY: the low-power mode is over.
+        Active_Known = false;     // The sample time grid went with ACTIVE mode.
     }
     
     // Check if the device reset -> boot sequesce is complete and device is ready. 
@@ -925,42 +1155,30 @@ bool MPL3115A2::MPL_System_Reset()  // Software reset of the MPL3115A2 unit. All
 
 void MPL3115A2::MPL_Altimeter_Mode()  // Set the device to operate as an Altimeter. Get_Altitude() must be used.
 {
-    char temp[2];
+    char temp_Reg1 = MPL_Read_Ctrl(CTRL_REG1) | CTRL_REG1_ALT;  // Makes sure we preserve the previous contents intact while setting only the required control bit. 
     
-    temp[0] = CTRL_REG1;                        // Read contents of CTRL_REG1 so we can OR our command bit while preserving the previous contents
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
-    
-    char temp_Reg1 = temp[0] | CTRL_REG1_ALT;  // Makes sure we preserve the previous contents intact while setting only the required control bit. . 
-    
-    temp[0] = CTRL_REG1;
-    temp[1] = temp_Reg1;
-    _i2c.write(MPL3115A2_WRITE,temp,2);
+    MPL_Write_Ctrl(CTRL_REG1, temp_Reg1);
 
     Bar_Mode = false;  // Indicate that the device is set to Altimeter mode
 }
 
 void MPL3115A2::MPL_Barometer_Mode()  // Set the device to operate an a Barometer. Get_Pressure() must be used.
 {
-    char temp[2];
-    
-    temp[0] = CTRL_REG1;                        // Read contents of CTRL_REG1 so we can OR our command bit while preserving the previous contents
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
+    char temp_Reg1 = MPL_Read_Ctrl(CTRL_REG1) & (~CTRL_REG1_ALT);  // Makes sure we preserve the previous contents intact while setting only the required control bit. This ANDs the register with (0x7F) where 0x7F = ~0x80 (CTRL_REG1_ALT)
     
-    char temp_Reg1 = temp[0] & (~CTRL_REG1_ALT);  // Makes sure we preserve the previous contents intact while setting only the required control bit. This ANDs temp[0] with (0x7F) where 0x7F = ~0x80 (CTRL_REG1_ALT)
-    
-    temp[0] = CTRL_REG1;
-    temp[1] = temp_Reg1;
-    _i2c.write(MPL3115A2_WRITE,temp,2);
+    MPL_Write_Ctrl(CTRL_REG1, temp_Reg1);
     
     Bar_Mode = true;  //Indicate that the device is set to Barometer mode
 }
 
+bool MPL3115A2::MPL_is_Barometer_Mode()  // Mode the next acquisition is converted in. From the driver state, no I2C traffic.
+{
+    return Bar_Mode;
+}
+
 void MPL3115A2::MPL_Set_Oversampling(char Oversampling)  // Sets the oversampling according to user input: 1,2,4,8...128 samples averaging.
 {   
     char o_s;
-    char temp[2];
     
     switch(Oversampling)
     {
@@ -983,16 +1201,14 @@ void MPL3115A2::MPL_Set_Oversampling(char Oversampling)  // Sets the oversamplin
         default: o_s = 0x00; break;
     }
  
-    temp[0] = CTRL_REG1;                        // Read contents of CTRL_REG1 so we can OR our command bit while preserving the previous contents
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
-    
-    char temp_Reg1 = (temp[0] & 0xC7) | o_s;   // The contents of the register preserved except bits [5:3] which are reset with 0xC7 {0011 1000}. After, the desired oversampling is ORed.
-    
-    temp[0] = CTRL_REG1;
-    temp[1] = temp_Reg1;
-    _i2c.write(MPL3115A2_WRITE,temp,2);
+    char temp_Reg1 = (MPL_Read_Ctrl(CTRL_REG1) & 0xC7) | o_s;   // The contents of the register preserved except bits [5:3] which are reset with 0xC7 {0011 1000}. After, the desired oversampling is ORed.
     
+    MPL_Write_Ctrl(CTRL_REG1, temp_Reg1);
+}
+
+char MPL3115A2::MPL_Get_Oversampling()  // Oversampling ratio currently set in CTRL_REG1: 1 to 128.
+{
+    return (char)(1 << ((MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_OS_128) >> 3));
 }
 
 
@@ -1005,8 +1221,16 @@ void MPL3115A2::MPL_Set_Interupt_Pins_and_Action(char Pin_Action, char Enable_In
     temp[2] = Enable_Interrupts;    // Enable interrupts for various events: Data Ready, FIFO interrupt, Pressure Window, T Window, Pressure Threshold, T Threshold, Pressure Change, and T Change.
     temp[3] = Interrupt_Route;      // Defines to which pin the event (or group of events) is routed. INT1 or INT2. Default: All go to INT2. 
     
-    _i2c.write(MPL3115A2_WRITE,temp,4);
+    MPL_Bus_Write(temp,4);
+    
+    Ctrl_Shadow[2] = Pin_Action;          // Keep the shadow copies of CTRL_REG3..CTRL_REG5 coherent with the burst write.
+    Ctrl_Shadow[3] = Enable_Interrupts;
+    Ctrl_Shadow[4] = Interrupt_Route;
     
+    if (Shadow_Verify == true)
+    {
+        MPL_Sync_Control_Registers();
+    }
 }
 
 char MPL3115A2::MPL_Get_Interrupt_Source()  // Since all interrupts are internaly ORed to the interrupt pins, this is needed to see what is causing the interrupt.
@@ -1014,8 +1238,625 @@ char MPL3115A2::MPL_Get_Interrupt_Source()  // Since all interrupts are internal
     char temp[1];
     
     temp[0] = INT_SOURCE;                        // Read contents of INT_SOURCE
-    _i2c.write(MPL3115A2_WRITE,temp,1,true);
-    _i2c.read(MPL3115A2_READ,temp,1);
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
     
     return (temp[0]);
 }
+
+void MPL3115A2::MPL_Set_FIFO_Mode(char FIFO_Mode, char Watermark)  // FIFO_Mode: F_SETUP_F_MODE_DISABLED, _CIRCULAR or _STOP. Watermark [0,31].
+{
+    char temp[2];
+    
+    if (Watermark > (F_DEPTH - 1)){Watermark = F_DEPTH - 1;}   // Watermark of 32 would never be reached before the overflow.
+    
+    temp[0] = F_SETUP;
+    
+    if (((FIFO_Setup & ~F_SETUP_F_WMRK) != F_SETUP_F_MODE_DISABLED) && (FIFO_Mode != F_SETUP_F_MODE_DISABLED))  // The FIFO must be disabled before switching between two non-zero modes.
+    {
+        temp[1] = F_SETUP_F_MODE_DISABLED;
+        MPL_Bus_Write(temp,2);
+    }
+    
+    FIFO_Setup = (FIFO_Mode & ~F_SETUP_F_WMRK) | (Watermark & F_SETUP_F_WMRK);
+    
+    temp[1] = FIFO_Setup;
+    MPL_Bus_Write(temp,2);
+}
+
+int MPL3115A2::MPL_Drain_FIFO(MPL_Sample *Buffer, int Max_Samples, char *FIFO_Status)  // Read up to Max_Samples pending samples from F_DATA in one burst.
+{
+    char temp[F_DEPTH * F_SAMPLE_BYTES];  // Room for a full FIFO: 32 samples of 5 bytes.
+    
+    temp[0] = F_STATUS;                    // Reading F_STATUS also clears the FIFO interrupt.
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
+    
+    uint32_t Read_us = us_ticker_read();
+    
+    if (FIFO_Status != NULL)
+    {
+        *FIFO_Status = temp[0];
+    }
+    
+    int Available = temp[0] & F_STATUS_F_CNT;
+    int Count = Available;
+    
+    if (Count > Max_Samples){Count = Max_Samples;}   // Samples left behind stay in the FIFO for the next drain.
+    
+    if (Count <= 0)
+    {
+        return 0;
+    }
+    
+    // Date the newest sample in the FIFO, the others are one time step apart before it.
+    //    Watermark interrupt of the low-power mode: it fired when the count reached the watermark. Exact.
+    //    Overflow:  TIME_DLY counts the whole time steps since the last sample was written (stop mode keeps the oldest samples).
+    //    Otherwise: the newest sample is less than one time step old.
+    // The last two only bound the time to one step. When this driver started ACTIVE mode the conversions fall on a known
+    // grid and the bound picks the conversion; without it the middle of the step halves the worst error.
+    uint32_t Step_us = MPL_Time_Step_us();
+    uint32_t Newest_us = Read_us;          // Latest possible time of the newest sample.
+    char Watermark = FIFO_Setup & F_SETUP_F_WMRK;
+    
+    if (((temp[0] & F_STATUS_F_OVF) == 0) && (Low_Power_FIFO == true) && (Watermark != 0) && (Available >= Watermark))
+    {
+        Newest_us = Data_Ready_us + (uint32_t)(Available - Watermark) * Step_us;
+    }
+    
+    else
+    {
+        if ((temp[0] & F_STATUS_F_OVF) != 0)
+        {
+            char Delay[1];
+            
+            Delay[0] = TIME_DLY;
+            MPL_Bus_Write(Delay,1,true);
+            MPL_Bus_Read(Delay,1);
+            
+            Newest_us = Read_us - (uint32_t)Delay[0] * Step_us;
+        }
+        
+        uint32_t First_us = Active_us + (uint32_t)MPL_Conversion_Time_us();   // First conversion of the grid.
+        
+        if ((Active_Known == true) && (Step_us != 0) && ((int32_t)(Newest_us - First_us) >= 0))
+        {
+            Newest_us = First_us + ((Newest_us - First_us) / Step_us) * Step_us;   // Last grid point not after the bound.
+        }
+        
+        else
+        {
+            Newest_us -= Step_us / 2;
+        }
+    }
+    
+    temp[0] = F_DATA;                      // F_DATA does not auto-increment: every byte read pops the next one out of the FIFO.
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,Count * F_SAMPLE_BYTES);
+    
+    for (int i = 0; i < Count; i++)
+    {
+        for (int j = 0; j < F_SAMPLE_BYTES; j++)
+        {
+            Buffer[i].Raw[j] = temp[(i * F_SAMPLE_BYTES) + j];
+        }
+        
+        Buffer[i].Bar_Mode = Bar_Mode;     // FIFO samples are converted in the current mode.
+        
+        MPL_Decode_Sample(Buffer[i]);
+        
+        Buffer[i].Timestamp_us = Newest_us - (uint32_t)(Available - 1 - i) * Step_us;   // Oldest first.
+    }
+    
+    return Count;
+}
+
+void MPL3115A2::MPL_Sync_Control_Registers()  // Reload the driver-side copy of CTRL_REG1..CTRL_REG5 from the device with one 5-byte burst read. BAR_IN and OFF_H are reloaded for the software altitude.
+{
+    Ctrl_Shadow[0] = CTRL_REG1;
+    MPL_Bus_Write(Ctrl_Shadow,1,true);
+    MPL_Bus_Read(Ctrl_Shadow,5);     // Auto-increment: CTRL_REG1, CTRL_REG2, CTRL_REG3, CTRL_REG4, CTRL_REG5
+    
+    Ctrl_Shadow[0] &= ~(CTRL_REG1_OST | CTRL_REG1_RST);  // Self-clearing bits are never kept in the shadow.
+    
+    Bar_Mode = ((Ctrl_Shadow[0] & CTRL_REG1_ALT) == 0);  // Keep the mode flag in line with the device.
+    
+    char temp[2];
+    
+    temp[0] = BAR_IN_MSB;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,2);
+    Bar_Reference_Pa = (uint32_t)((temp[0] << 8) | temp[1]) * 2;
+    
+    temp[0] = OFF_H;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,1);
+    Altitude_Trim = (int8_t)temp[0];
+    
+    MPL_Altitude_Set_Reference(Altitude_Reference, Bar_Reference_Pa, Altitude_Trim);  // The software altitude follows the device reference.
+    
+    Shadow_Valid = true;
+}
+
+bool MPL3115A2::MPL_Enable_Data_Ready_Interrupt(bool Route_To_INT1)  // Route the Data Ready interrupt to INT1 ('true') or INT2 ('false') and wait on it instead of polling CTRL_REG1.
+{
+    char temp[6];
+    
+    if (Int_Pin == NULL)
+    {
+        return false;  // No MCU pin to receive the interrupt.
+    }
+    
+    temp[0] = PT_DATA_CFG;
+    temp[1] = PDEFE | TDEFE;   // Raise the data event flag on every new Pressure/Altitude and Temperature acquisition (DREM = '0').
+    MPL_Bus_Write(temp,2);
+    
+    MPL_Route_Interrupt(CTRL_REG4_INT_EN_DRDY, Route_To_INT1);
+    
+    // A stale data-ready condition would hold the pad asserted and no edge would follow. Reading STATUS and OUT_P/OUT_T clears it.
+    temp[0] = STATUS;
+    MPL_Bus_Write(temp,1,true);
+    MPL_Bus_Read(temp,6);
+    
+    Data_Ready = false;
+    Data_Ready_Mode = true;
+    
+    return true;
+}
+
+void MPL3115A2::MPL_Disable_Data_Ready_Interrupt()  // Return to polling the OST bit.
+{
+    Data_Ready_Mode = false;
+    
+    if (Int_Pin != NULL)
+    {
+        Int_Pin->rise(NULL);
+        Int_Pin->fall(NULL);
+    }
+    
+    MPL_Set_Interupt_Pins_and_Action(MPL_Read_Ctrl(CTRL_REG3), MPL_Read_Ctrl(CTRL_REG4) & ~CTRL_REG4_INT_EN_DRDY, MPL_Read_Ctrl(CTRL_REG5));
+}
+
+void MPL3115A2::MPL_Route_Interrupt(char Source, bool Route_To_INT1)  // Enable one interrupt source, route it and attach MPL_Data_Ready_ISR() to the active edge of int_pin.
+{
+    char Pin_Action = MPL_Read_Ctrl(CTRL_REG3);
+    char Enable_Interrupts = MPL_Read_Ctrl(CTRL_REG4) | Source;
+    char Interrupt_Route = MPL_Read_Ctrl(CTRL_REG5);
+    char Polarity;
+    
+    if (Route_To_INT1 == true)
+    {
+        Interrupt_Route |= Source;
+        Polarity = Pin_Action & CTRL_REG3_IPOL1;
+    }
+    
+    else
+    {
+        Interrupt_Route &= ~Source;
+        Polarity = Pin_Action & CTRL_REG3_IPOL2;
+    }
+    
+    if (Polarity != 0)  // Active high pad: trigger on the rising edge.
+    {
+        Int_Pin->fall(NULL);
+        Int_Pin->rise(this, &MPL3115A2::MPL_Data_Ready_ISR);
+    }
+    
+    else                // Active low pad (default): trigger on the falling edge.
+    {
+        Int_Pin->rise(NULL);
+        Int_Pin->fall(this, &MPL3115A2::MPL_Data_Ready_ISR);
+    }
+    
+    MPL_Set_Interupt_Pins_and_Action(Pin_Action, Enable_Interrupts, Interrupt_Route);
+}
+
+bool MPL3115A2::MPL_Start_Low_Power(uint16_t Period, char Watermark, bool Route_To_INT1)  // ACTIVE sampling every Period seconds, the core sleeps between sensor interrupts.
+{
+    if (Int_Pin == NULL)
+    {
+        return false;  // Nothing could wake the core.
+    }
+    
+    MPL_Stop_Continuous();   // F_SETUP and the time step are changed in STANDBY.
+    
+    if (Watermark == 0)   // One wake-up per sample: Data Ready, OUT_P/OUT_T read with MPL_Read_Latest_Sample().
+    {
+        MPL_Set_FIFO_Mode(F_SETUP_F_MODE_DISABLED, 0);
+        MPL_Enable_Data_Ready_Interrupt(Route_To_INT1);
+        Low_Power_FIFO = false;
+    }
+    
+    else                  // One wake-up per Watermark samples: the FIFO holds them meanwhile.
+    {
+        MPL_Disable_Data_Ready_Interrupt();   // Data Ready would still fire on every sample.
+        MPL_Set_FIFO_Mode(F_SETUP_F_MODE_STOP, Watermark);
+        MPL_Route_Interrupt(CTRL_REG4_INT_EN_FIFO, Route_To_INT1);
+        Low_Power_FIFO = true;
+    }
+    
+    MPL_Start_Continuous(Period);
+    
+    Low_Power_Step_us = MPL_Time_Step_us();   // 0 for steps beyond 2048 s: no timeout, no deep sleep time base.
+    
+    Data_Ready = false;
+    
+    memset(&Duty, 0, sizeof(Duty));
+    Low_Power_Wake_us = us_ticker_read();
+    
+    return true;
+}
+
+int MPL3115A2::MPL_Sleep_Until_Samples(MPL_Sample *Buffer, int Max_Samples, bool Deep_Sleep)  // Sleep until the sensor interrupt, then read the new samples.
+{
+    uint32_t Sleep_us = us_ticker_read();
+    uint32_t Expected_us = (Low_Power_FIFO == true) ? Low_Power_Step_us * (FIFO_Setup & F_SETUP_F_WMRK) : Low_Power_Step_us;
+    
+    Duty.Awake_us += Sleep_us - Low_Power_Wake_us;   // Everything since the previous wake-up, the application's work included.
+    
+    if (Deep_Sleep == false)
+    {
+        Duty.Elapsed_us += Sleep_us - Low_Power_Wake_us;
+    }
+    
+    // sleep() keeps the peripherals clocked, so the timeout can end a wait for an interrupt that never comes.
+    // deepsleep() stops them on the LPC1768: only the pin interrupt wakes the core, and the wait has no timeout.
+    // The pad stays asserted until the data is read: Sleeper tests the flag and sleeps with interrupts masked, so an
+    // edge just before the sleep is not slept through.
+    uint32_t Timeout_us = 0;
+    
+    if ((Deep_Sleep == false) && (Expected_us != 0) && (Expected_us <= 0x7FFFFFFFUL / MPL_CONVERSION_TIMEOUT))
+    {
+        Timeout_us = MPL_CONVERSION_TIMEOUT * Expected_us;
+    }
+    
+    Sleeper.Sleep(&Data_Ready, Timeout_us, Deep_Sleep);
+    
+    Low_Power_Wake_us = us_ticker_read();
+    
+    if (Deep_Sleep == false)
+    {
+        Duty.Elapsed_us += Low_Power_Wake_us - Sleep_us;
+    }
+    
+    if (Data_Ready == false)
+    {
+        return 0;
+    }
+    
+    Data_Ready = false;   // Cleared before the read: the read releases the pad, the next sample gives a new edge.
+    Duty.Wakeups++;
+    
+    int Count = 0;
+    
+    if (Low_Power_FIFO == true)
+    {
+        Count = MPL_Drain_FIFO(Buffer, Max_Samples);   // Reading F_STATUS clears the watermark interrupt.
+    }
+    
+    else if (Max_Samples > 0)
+    {
+        MPL_Read_Latest_Sample(Buffer[0]);   // Reading OUT_P/OUT_T clears the Data Ready interrupt.
+        Count = 1;
+    }
+    
+    Duty.Samples += Count;
+    
+    if (Deep_Sleep == true)   // The us_ticker did not run while asleep: wake-up to wake-up is counted on the sensor clock.
+    {
+        Duty.Elapsed_us += (uint64_t)Count * Low_Power_Step_us;
+    }
+    
+    return Count;
+}
+
+void MPL3115A2::MPL_Stop_Low_Power()  // Back to STANDBY. Interrupts and FIFO disabled.
+{
+    MPL_Stop_Continuous();
+    
+    Data_Ready_Mode = false;
+    
+    if (Int_Pin != NULL)
+    {
+        Int_Pin->rise(NULL);
+        Int_Pin->fall(NULL);
+    }
+    
+    MPL_Set_Interupt_Pins_and_Action(MPL_Read_Ctrl(CTRL_REG3), MPL_Read_Ctrl(CTRL_REG4) & ~(CTRL_REG4_INT_EN_DRDY | CTRL_REG4_INT_EN_FIFO), MPL_Read_Ctrl(CTRL_REG5));
+    MPL_Set_FIFO_Mode(F_SETUP_F_MODE_DISABLED, 0);
+    Low_Power_FIFO = false;
+}
+
+void MPL3115A2::MPL_Get_Duty_Cycle(MPL_Duty_Cycle &Result)  // Awake/elapsed time since MPL_Start_Low_Power(), up to the last time the core went to sleep.
+{
+    Result = Duty;
+    Result.Awake_ppm = (Result.Elapsed_us != 0) ? (uint32_t)((Result.Awake_us * 1000000) / Result.Elapsed_us) : 0;
+}
+
+void MPL3115A2::MPL_Data_Ready_ISR()  // Attached to int_pin. Only raises the Data_Ready flag (or starts the non-blocking read of an asynchronous sample).
+{
+    Data_Ready_us = us_ticker_read();   // Closest the MCU gets to the end of the conversion: the edge is raised as the result lands in OUT_P/OUT_T.
+    Data_Ready = true;
+    
+#if DEVICE_I2C_ASYNCH
+    if (Async_State == MPL_ASYNC_CONVERT)  // No need to wait for the timeout, the data is already there.
+    {
+        Async_Timer.detach();
+        MPL_Async_Converted();
+    }
+#endif
+}
+
+void MPL3115A2::MPL_Begin_Batch()  // Until MPL_Flush(), the reference, target, window and trim setters stage their registers instead of writing them.
+{
+    Batching = true;
+}
+
+int MPL3115A2::MPL_Flush()  // Write every staged register. Dirty adjacent registers are merged into one auto-increment write.
+{
+    char temp[MPL_REGISTER_COUNT + 1];
+    int Writes = 0;
+    char Address = 0;
+    
+    Batching = false;
+    
+    while (Address < MPL_REGISTER_COUNT)
+    {
+        if ((Staged_Mask & (1ULL << Address)) == 0)
+        {
+            Address++;
+            continue;
+        }
+        
+        int Length = 0;
+        
+        temp[0] = Address;
+        
+        while (((Address + Length) < MPL_REGISTER_COUNT) && ((Staged_Mask & (1ULL << (Address + Length))) != 0))  // Run of adjacent staged registers. OFF_H is the end of the map: auto-increment wraps to WHO_AM_I there.
+        {
+            temp[1 + Length] = Staged[Address + Length];
+            Length++;
+        }
+        
+        MPL_Bus_Write(temp, 1 + Length);
+        Writes++;
+        
+        for (int i = 0; i < Length; i++)
+        {
+            MPL_Apply_Register_Write(Address + i, temp[1 + i]);
+        }
+        
+        Address += Length;
+    }
+    
+    Staged_Mask = 0;
+    
+    if ((Shadow_Verify == true) && (Writes != 0))
+    {
+        MPL_Sync_Control_Registers();
+    }
+    
+    return Writes;
+}
+
+void MPL3115A2::MPL_Write_Registers(const char *data, int length)  // data[0] is the first register address. Staged while a batch is open, otherwise one burst write.
+{
+    if (Batching == false)
+    {
+        MPL_Bus_Write(data, length);
+        return;
+    }
+    
+    for (int i = 1; i < length; i++)
+    {
+        MPL_Stage_Byte(data[0] + i - 1, data[i]);
+    }
+}
+
+void MPL3115A2::MPL_Read_Registers(char Address, char *data, int length)  // Staged bytes when all of them are pending in the open batch, otherwise one burst read.
+{
+    bool All_Staged = Batching;
+    
+    for (int i = 0; i < length; i++)
+    {
+        if ((Staged_Mask & (1ULL << (Address + i))) == 0)
+        {
+            All_Staged = false;
+        }
+    }
+    
+    if (All_Staged == true)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            data[i] = Staged[Address + i];
+        }
+        
+        return;
+    }
+    
+    data[0] = Address;
+    MPL_Bus_Write(data, 1, true);
+    MPL_Bus_Read(data, length);
+}
+
+void MPL3115A2::MPL_Stage_Byte(char Address, char Value)  // Read-only addresses are ignored.
+{
+    if (((unsigned char)Address >= MPL_REGISTER_COUNT) || (MPL_Register_Is_Writable(Address) == false))
+    {
+        return;
+    }
+    
+    Staged[(unsigned char)Address] = Value;
+    Staged_Mask |= (1ULL << Address);
+}
+
+void MPL3115A2::MPL_Apply_Register_Write(char Address, char Value)  // Keep the driver-side copies coherent with a register write done by MPL_Flush().
+{
+    if ((Address >= CTRL_REG1) && (Address <= CTRL_REG5))
+    {
+        if (Address == CTRL_REG1)
+        {
+            Value &= ~(CTRL_REG1_OST | CTRL_REG1_RST);  // Self-clearing bits are never kept in the shadow.
+            Bar_Mode = ((Value & CTRL_REG1_ALT) == 0);
+        }
+        
+        Ctrl_Shadow[Address - CTRL_REG1] = Value;
+    }
+    
+    else if (Address == F_SETUP)
+    {
+        FIFO_Setup = Value;
+    }
+    
+    else if ((Address == BAR_IN_MSB) || (Address == BAR_IN_LSB) || (Address == OFF_H))
+    {
+        uint16_t Bar_In = (uint16_t)(Bar_Reference_Pa / 2);
+        
+        if (Address == BAR_IN_MSB){Bar_In = (uint16_t)((Bar_In & 0x00FF) | ((uint16_t)(uint8_t)Value << 8));}
+        if (Address == BAR_IN_LSB){Bar_In = (uint16_t)((Bar_In & 0xFF00) | (uint8_t)Value);}
+        if (Address == OFF_H){Altitude_Trim = (int8_t)Value;}
+        
+        Bar_Reference_Pa = (uint32_t)Bar_In * 2;
+        MPL_Altitude_Set_Reference(Altitude_Reference, Bar_Reference_Pa, Altitude_Trim);
+    }
+}
+
+int MPL3115A2::MPL_Conversion_Time_us()  // Conversion time of one acquisition for the oversampling ratio currently set in CTRL_REG1. See CTRL_REG1_OS_n in MPL3115A2_REGISTER_MAP.h.
+{
+    return (int)MPL_Conversion_Time_Table_us[(MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_OS_128) >> 3];
+}
+
+uint32_t MPL3115A2::MPL_Time_Step_us()  // ACTIVE mode time step set in CTRL_REG2. 0 when it does not fit 32 bits.
+{
+    char Time_Step = MPL_Read_Ctrl(CTRL_REG2) & CTRL_REG2_ST;
+    
+    return (Time_Step <= 11) ? (1000000UL << Time_Step) : 0;   // 2^ST s: up to 2048 s in 32-bit microseconds.
+}
+
+uint32_t MPL3115A2::MPL_Sample_Time_us()  // Best estimate of the us_ticker time of the conversion now in OUT_P/OUT_T.
+{
+    if (Data_Ready_Mode == true)   // The edge of the interrupt is the end of the conversion.
+    {
+        return Data_Ready_us;
+    }
+    
+    if ((MPL_Read_Ctrl(CTRL_REG1) & CTRL_REG1_SBYB) == 0)   // Polled one-shot: the result was ready one conversion time after the trigger.
+    {
+        return Trigger_us + MPL_Conversion_Time_us();
+    }
+    
+    return us_ticker_read();   // ACTIVE mode without interrupt: somewhere within the last time step.
+}
+
+void MPL3115A2::MPL_Set_Shadow_Verify(bool Verify)  // 'true' - every control register write is read back and the shadow copy is resynchronized on mismatch.
+{
+    Shadow_Verify = Verify;
+}
+
+char MPL3115A2::MPL_Read_Ctrl(char Register)  // Returns the shadow copy of CTRL_REGn. No I2C traffic unless the shadow has not been synchronized yet.
+{
+    if (Shadow_Valid == false)
+    {
+        MPL_Sync_Control_Registers();
+    }
+    
+    return Ctrl_Shadow[Register - CTRL_REG1];
+}
+
+void MPL3115A2::MPL_Write_Ctrl(char Register, char Value)  // Single 2-byte write of CTRL_REGn. Keeps the shadow copy coherent.
+{
+    char temp[2];
+    
+    temp[0] = Register;
+    temp[1] = Value;
+    MPL_Bus_Write(temp,2);
+    
+    if (Register == CTRL_REG1)
+    {
+        Value &= ~(CTRL_REG1_OST | CTRL_REG1_RST);  // OST and RST are auto-cleared by the device.
+    }
+    
+    Ctrl_Shadow[Register - CTRL_REG1] = Value;
+    
+    if (Shadow_Verify == true)  // Optional read-back. On mismatch the whole shadow is reloaded from the device.
+    {
+        temp[0] = Register;
+        MPL_Bus_Write(temp,1,true);
+        MPL_Bus_Read(temp,1);
+        
+        if (Register == CTRL_REG1)
+        {
+            temp[0] &= ~(CTRL_REG1_OST | CTRL_REG1_RST);
+        }
+        
+        if (temp[0] != Value)
+        {
+            MPL_Sync_Control_Registers();
+        }
+    }
+}
+
+#ifdef MPL3115A2_BUS_STATS
+int MPL3115A2::MPL_Bus_Write(const char *data, int length, bool repeated)  // Instrumented write. The first byte is the register pointer.
+{
+    if (length > 0)
+    {
+        Bus_Stats_Register = data[0];
+    }
+    
+    uint32_t Start = us_ticker_read();
+    int Result = _i2c.write(MPL3115A2_WRITE, data, length, repeated);
+    
+    MPL_Account_Transfer(length, Result, us_ticker_read() - Start);
+    
+    return Result;
+}
+
+int MPL3115A2::MPL_Bus_Read(char *data, int length, bool repeated)  // Instrumented read. Accounted to the register addressed by the last write.
+{
+    uint32_t Start = us_ticker_read();
+    int Result = _i2c.read(MPL3115A2_READ, data, length, repeated);
+    
+    MPL_Account_Transfer(length, Result, us_ticker_read() - Start);
+    
+    return Result;
+}
+
+void MPL3115A2::MPL_Account_Transfer(int length, int Result, uint32_t Duration_us)  // One transfer into the per-register counters and the latency histogram.
+{
+    char Bucket = 0;
+    char Register = ((unsigned char)Bus_Stats_Register < MPL_BUS_STATS_REGISTERS) ? Bus_Stats_Register : 0;
+    
+    Bus_Stats.Total_Time_us += Duration_us;
+    
+    while ((Duration_us != 0) && (Bucket < (MPL_BUS_STATS_BUCKETS - 1)))  // Bucket = number of significant bits of the duration.
+    {
+        Duration_us >>= 1;
+        Bucket++;
+    }
+    
+    Bus_Stats.Transfers[(unsigned char)Register]++;
+    Bus_Stats.Bytes[(unsigned char)Register] += length;
+    Bus_Stats.Latency[(unsigned char)Bucket]++;
+    Bus_Stats.Total_Transfers++;
+    Bus_Stats.Total_Bytes += length;
+    
+    if (Result != 0)
+    {
+        Bus_Stats.Nacks[(unsigned char)Register]++;
+        Bus_Stats.Total_Nacks++;
+    }
+}
+
+void MPL3115A2::MPL_Get_Bus_Stats(MPL_Bus_Stats &Stats)  // Snapshot of the bus counters. The counters are only updated from thread context, a plain copy is consistent.
+{
+    Stats = Bus_Stats;
+}
+
+void MPL3115A2::MPL_Reset_Bus_Stats()  // Zero all bus counters.
+{
+    memset(&Bus_Stats, 0, sizeof(Bus_Stats));
+    Bus_Stats_Register = 0;
+}
+#endif
@@ -3,27 +3,119 @@
 #define MPL3115A2_IO_H_
 
 #include <stdint.h>    // to handle uintN_t and intN_t integer types
+#include "MPL3115A2_Altitude.h"
+#include "MPL3115A2_Registers.h"
+#include "MPL3115A2_Sleep.h"
+
+struct MPL_Sample   // One Pressure/Altitude and Temperature acquisition retrieved with a single burst read of OUT_P_MSB..OUT_T_LSB
+{
+    char   Raw[5];        // Raw register contents: OUT_P_MSB, OUT_P_CSB, OUT_P_LSB, OUT_T_MSB, OUT_T_LSB
+    bool   Bar_Mode;      // 'true' - the sample was converted in Barometer mode and Pressure is valid. 'false' - Altimeter mode and Altitude is valid.
+    int32_t Pressure_Fixed;     // Q18.2 Pa (0.25 Pa per LSB). 0 when the sample was taken in Altimeter mode.
+    int32_t Altitude_Fixed;     // Q16.4 m (0.0625 m per LSB). In Barometer mode computed from Pressure_Fixed, see MPL3115A2_Altitude.h
+    int32_t Temperature_Fixed;  // Q8.4 C (0.0625 C per LSB).
+    double Pressure;      // Pascals. 0 when the sample was taken in Altimeter mode.
+    double Altitude;      // Meters. Valid in both modes: measured in Altimeter mode, computed from Pressure in Barometer mode.
+    double Temperature;   // Degrees C. Valid in both modes.
+    uint32_t Timestamp_us;  // us_ticker at the end of the conversion. Data Ready interrupt time when enabled, trigger + conversion time for polled one-shots, time of the read otherwise. FIFO samples: reconstructed from the time step, see MPL_Drain_FIFO().
+};
+
+struct MPL_Frame   // Current values, deltas and data-ready flags of one acquisition: STATUS..OUT_T_DELTA_LSB (0x00-0x0B)
+{
+    char   Raw[12];       // Raw register contents 0x00..0x0B
+    char   Status;        // DR_STATUS flags as they were before the values were read (reading clears them). See DR_* in MPL3115A2_REGISTER_MAP.h
+    MPL_Sample Current;   // OUT_P/OUT_T, decoded as MPL_Read_Sample() does.
+    int32_t Pressure_Change_Fixed;     // Q18.2 Pa. 0 in Altimeter mode.
+    int32_t Altitude_Change_Fixed;     // Q16.4 m. In Barometer mode computed from the two pressures, see MPL3115A2_Altitude.h
+    int32_t Temperature_Change_Fixed;  // Q8.4 C
+    double Pressure_Change;      // Pascals
+    double Altitude_Change;      // Meters
+    double Temperature_Change;   // Degrees C
+};
+
+struct MPL_Extremes   // Min/max registers P_MIN_MSB..T_MAX_LSB retrieved with a single 10-byte burst read
+{
+    char   Raw[10];       // Raw register contents: P_MIN (3), T_MIN (2), P_MAX (3), T_MAX (2)
+    bool   Bar_Mode;      // Mode the P_MIN/P_MAX registers are interpreted in: the current mode of the driver.
+    int32_t Min_Pressure_Fixed;     // Q18.2 Pa. 0 in Altimeter mode.
+    int32_t Max_Pressure_Fixed;
+    int32_t Min_Altitude_Fixed;     // Q16.4 m. In Barometer mode computed from Max_Pressure_Fixed (the highest pressure is the lowest altitude), see MPL3115A2_Altitude.h
+    int32_t Max_Altitude_Fixed;
+    int32_t Min_Temperature_Fixed;  // Q8.4 C. Valid in both modes.
+    int32_t Max_Temperature_Fixed;
+    double Min_Pressure, Max_Pressure;        // Pascals
+    double Min_Altitude, Max_Altitude;        // Meters
+    double Min_Temperature, Max_Temperature;  // Degrees C
+};
+
+struct MPL_Duty_Cycle   // Time the MCU spent awake in the low-power acquisition mode, since MPL_Start_Low_Power()
+{
+    uint32_t Wakeups;      // Sensor interrupts that woke the core
+    uint32_t Samples;      // Samples returned by MPL_Sleep_Until_Samples()
+    uint64_t Awake_us;     // From every wake-up to the next sleep: bus reads plus the application's own work
+    uint64_t Elapsed_us;   // Total time. After deepsleep() it is counted on the sensor clock (samples x time step): the us_ticker stops in deep sleep.
+    uint32_t Awake_ppm;    // Awake_us / Elapsed_us in parts per million
+};
+
+#ifdef MPL3115A2_BUS_STATS
+#define MPL_BUS_STATS_REGISTERS 0x2E   // STATUS (0x00) .. OFF_H (0x2D)
+#define MPL_BUS_STATS_BUCKETS   16     // Latency histogram: bucket 0 < 1 us, bucket n covers [2^(n-1), 2^n) us, the last one collects everything above.
+
+struct MPL_Bus_Stats   // Blocking I2C traffic of one driver instance. Compiled in with -DMPL3115A2_BUS_STATS only.
+{
+    uint32_t Transfers[MPL_BUS_STATS_REGISTERS];  // write()/read() calls per register. A read is accounted to the register addressed by the preceding pointer write.
+    uint32_t Bytes[MPL_BUS_STATS_REGISTERS];      // Payload bytes moved per register, register pointer included.
+    uint32_t Nacks[MPL_BUS_STATS_REGISTERS];      // Transfers not acknowledged per register.
+    uint32_t Latency[MPL_BUS_STATS_BUCKETS];      // log2 histogram of the duration of each transfer, measured with us_ticker.
+    uint32_t Total_Transfers;
+    uint32_t Total_Bytes;
+    uint32_t Total_Nacks;
+    uint32_t Total_Time_us;                       // Sum of all transfer durations.
+};
+#endif
 
 class MPL3115A2
 {
 
 public:
 
-    MPL3115A2(PinName sda, PinName scl);
+    MPL3115A2(PinName sda, PinName scl, PinName int_pin = NC);  // int_pin: MCU pin wired to the INT1 or INT2 pad of the sensor. Optional, required only for the interrupt-driven data-ready path.
+
+    ~MPL3115A2();                  // Detaches the data-ready handler and releases the interrupt pin.
     
     void MPL_Init();               // Use to initialize proper settings: Oversampling, Device Mode, Interrupts etc.
     
     void MPL_Set_Oversampling(char Oversampling);   // Set the oversample ration of the data aquisition. 1 to 128 in 2^n intervals. NOTE: Consult REGISTER_MAP.h for minimum timing intervals
 
+    char MPL_Get_Oversampling();  // Oversampling ratio currently set in CTRL_REG1: 1 to 128. From the shadow copy, no I2C traffic once synchronized.
+
     char MPL_Who_Am_I_();          // Reads and returns the device ID. By default MPL3115A2 return 0xC4.
     
     char MPL_Get_Status();         // Reads the STATUS register and returns the contents. Can find if new P,A,T data is available for retrieval.
 
-    double MPL_Get_Pressure();     // Returns the Atmospheric Pressure reading.
+    double MPL_Get_Pressure();     // Returns the Atmospheric Pressure reading. NAN when the conversion timed out.
+
+    double MPL_Get_Altitude();     // Returns the Altitude reading. NAN when the conversion timed out.
 
-    double MPL_Get_Altitude();     // Returns the Altitude reading.
+    double MPL_Get_Temperature();  // Returns Teperature reading. NAN when the conversion timed out.
 
-    double MPL_Get_Temperature();  // Returns Teperature reading.
+    bool MPL_Read_Sample(MPL_Sample &Sample);  // Single acquisition of Pressure/Altitude (depending on the current mode) and Temperature. One OST trigger and one 5-byte burst read. Returns 'false' on conversion timeout: nothing is read and Sample is left as it was.
+
+    bool MPL_Conversion_Complete();  // Non-blocking check of the acquisition started by MPL_One_Shot_Measure(). No I2C traffic when the Data Ready interrupt is enabled, otherwise one CTRL_REG1 read.
+
+    void MPL_Fetch_Sample(MPL_Sample &Sample);  // 5-byte burst read of OUT_P_MSB..OUT_T_LSB without triggering. Use after MPL_Conversion_Complete() returns 'true'.
+
+    int MPL_Conversion_Time_us();  // Conversion time of one acquisition for the oversampling ratio currently set in CTRL_REG1.
+
+    uint32_t MPL_Time_Step_us();  // ACTIVE mode time step set in CTRL_REG2. 0 when it does not fit 32 bits (steps beyond 2048 s).
+
+    uint32_t MPL_Sample_Time_us();  // Best estimate of the us_ticker time of the conversion now in OUT_P/OUT_T, as stored in MPL_Sample::Timestamp_us. Lets the double getters be timestamped too.
+
+#if DEVICE_I2C_ASYNCH   // Targets whose HAL has asynchronous I2C (not the LPC1768). Run on the host by the bench through the I2C::transfer() stand-in.
+    bool MPL_Start_Sample(MPL_Sample &Sample, Callback<void(bool)> Done);  // Non-blocking MPL_Read_Sample(). Trigger -> conversion -> burst read are chained in callbacks. Done(true) is called from the interrupt context once Sample is filled. Returns 'false' if a sample is already in progress or the bus is busy.
+
+    bool MPL_Sample_Busy();  // 'true' while an asynchronous sample is in progress.
+#endif
 
     double MPL_Get_Pressure_Change();     // Returns the Atmospheric Pressure reading.
 
@@ -31,6 +123,20 @@ public:
 
     double MPL_Get_Temperature_Change();  // Returns Teperature reading.
 
+    // Integer versions of the getters above. No soft-float: raw register value, sign-extended. The double getters are built on these.
+
+    int32_t MPL_Get_Pressure_Fixed();     // Pressure in Q18.2 Pa (0.25 Pa per LSB). MPL_NO_READING when the conversion timed out.
+
+    int32_t MPL_Get_Altitude_Fixed();     // Altitude in Q16.4 m (0.0625 m per LSB). MPL_NO_READING when the conversion timed out.
+
+    int32_t MPL_Get_Temperature_Fixed();  // Temperature in Q8.4 C (0.0625 C per LSB). MPL_NO_READING when the conversion timed out.
+
+    int32_t MPL_Get_Pressure_Change_Fixed();     // Pressure change in Q18.2 Pa.
+
+    int32_t MPL_Get_Altitude_Change_Fixed();     // Altitude change in Q16.4 m.
+
+    int32_t MPL_Get_Temperature_Change_Fixed();  // Temperature change in Q8.4 C.
+
     void MPL_Trim_Pressure(int16_t P_Trim);  // Pressure Trimming [-512,508] Pa. 4Pa per LSB
 
     void MPL_Trim_Altitude(int8_t A_Trim);  // Altitude Trimming [-128,127] meters. 1 m per LSB.
@@ -43,6 +149,10 @@ public:
     
     uint32_t MPL_Get_Barometric_Reference();  // Returns current Atmospheric reference at current location for Altitude calculations. 
 
+    int32_t MPL_Altitude_From_Pressure_Fixed(int32_t Pressure_Fixed);  // Q18.2 Pa -> Q16.4 m with the same BAR_IN reference and OFF_H trim as the device. No I2C traffic once the control registers are synchronized.
+
+    void MPL_Set_Software_Altitude(bool Enable);  // 'true' - MPL_Get_Altitude() stays in Barometer mode and computes Altitude from Pressure instead of switching to Altimeter mode. Default: 'false'.
+
     void MPL_Set_Pressure_Target(uint32_t P_Target);  //  Target Pressure for interrupts/alarms. Units: Pascals  [50kPa to 110kPa is 2Pa increments]
 
     void MPL_Set_Altitude_Target(int16_t A_Target);   //  Target Altitude for interrupts/alarms. Units: meters   [0 to 5000 meters. 1m increments]
@@ -75,6 +185,16 @@ public:
 
     void MPL_Reset_Max_T();  // Reset the Highest recorded Temperature
 
+    void MPL_Get_Extremes(MPL_Extremes &Extremes, bool Reset = false);  // All six min/max values from one 10-byte burst read. Reset = 'true' clears all of them right after with one 11-byte burst write.
+
+    void MPL_Start_Continuous(uint16_t Period);  // Switch to ACTIVE mode: the sensor samples on its own timer every Period seconds, rounded up to 2^n [1, 32768]. No OST trigger or polling per sample.
+
+    void MPL_Stop_Continuous();  // Return to STANDBY (one-shot) mode.
+
+    bool MPL_Read_Latest_Sample(MPL_Sample &Sample);  // Read STATUS..OUT_T_LSB in one 6-byte burst. Returns 'true' if the sample is new since the last read. Use in continuous mode.
+
+    bool MPL_Read_Frame(MPL_Frame &Frame);  // Values, deltas and status of the same acquisition. Two 6-byte bursts (the auto-increment wraps at 0x05 and 0x0B), repeated if an acquisition lands in between. FIFO must be disabled. Returns 'true' if the data is new since the last read.
+
     void MPL_One_Shot_Measure();  //Initiate one-shot acquisition of Pressure/Altitude and Temperature. Retrieve the data with MPL_Get_...() functions.
 
     bool MPL_System_Reset();  // Software reset of the MPL3115A5 unit. All registers defaulted. I2C is frozen to prevent data corruption. Returns 'true' if the device is succesfully reset and is ready after boot. '0' - otherwise.
@@ -83,18 +203,145 @@ public:
 
     void MPL_Barometer_Mode();  // Set the device to operate an a Barometer. Get_Pressure() must be used.
 
+    bool MPL_is_Barometer_Mode();  // 'true' - Barometer mode, 'false' - Altimeter mode. From the driver state, no I2C traffic.
+
     void MPL_Set_Interupt_Pins_and_Action(char Pin_Action, char Enable_Interrupts, char Interrupt_Route);  // Specify what pins generate the interrupts.
 
     char MPL_Get_Interrupt_Source();  // Since all interrupts are internaly ORed to the interrupt pins, this is needed to see what is causing the interrupt.
 
+    void MPL_Set_FIFO_Mode(char FIFO_Mode, char Watermark);  // FIFO_Mode: F_SETUP_F_MODE_DISABLED, _CIRCULAR or _STOP. Watermark [0,31], '0' disables the watermark event. The FIFO fills in ACTIVE mode only.
+
+    int MPL_Drain_FIFO(MPL_Sample *Buffer, int Max_Samples, char *FIFO_Status = NULL);  // Read up to Max_Samples pending samples from F_DATA in one burst. Returns the number of samples stored in Buffer. F_STATUS is optionally returned.
+                                                                                        // Timestamps are spaced by the time step back from the newest sample, dated by TIME_DLY after an overflow, by the watermark interrupt in low-power FIFO mode, otherwise by the read.
+
+    void MPL_Sync_Control_Registers();  // Reload the driver-side copy of CTRL_REG1..CTRL_REG5 from the device with one 5-byte burst read. BAR_IN and OFF_H are reloaded for the software altitude.
+
+    bool MPL_Enable_Data_Ready_Interrupt(bool Route_To_INT1);  // Route the Data Ready interrupt to INT1 ('true') or INT2 ('false') and wait on it instead of polling CTRL_REG1. Returns 'false' if no int_pin was given.
+
+    void MPL_Disable_Data_Ready_Interrupt();  // Return to polling the OST bit.
+
+    bool MPL_Start_Low_Power(uint16_t Period, char Watermark = 0, bool Route_To_INT1 = true);  // ACTIVE sampling every Period seconds (2^n). Watermark 0 - the Data Ready interrupt wakes the core on every sample. 1..31 - samples collect in the FIFO and the watermark interrupt wakes the core once per Watermark samples. Returns 'false' if no int_pin was given.
+
+    int MPL_Sleep_Until_Samples(MPL_Sample *Buffer, int Max_Samples, bool Deep_Sleep = false);  // sleep() (or deepsleep()) until the sensor interrupt, then read the new samples: one in Data Ready mode, up to Max_Samples from the FIFO. Returns the number of samples, 0 on timeout.
+
+    void MPL_Stop_Low_Power();  // Back to STANDBY. Interrupts and FIFO disabled.
+
+    void MPL_Get_Duty_Cycle(MPL_Duty_Cycle &Result);  // Awake/elapsed time since MPL_Start_Low_Power(), up to the last time the core went to sleep.
+
+    void MPL_Set_Shadow_Verify(bool Verify);  // 'true' - every control register write is read back and the shadow copy is resynchronized on mismatch. Default: 'false'.
+
+    void MPL_Begin_Batch();  // Until MPL_Flush(), the reference, target, window and trim setters stage their registers instead of writing them.
+
+    template <class Register>
+    void MPL_Stage(uint32_t Value)  // Stage a writable field of MPL3115A2_Registers.h, e.g. MPL_Stage<MPL_Reg_P_TGT>(50000). Big-endian, Register::Width bytes. Written by MPL_Flush().
+    {
+        typedef char Register_Must_Be_Writable[(Register::Access == MPL_ACCESS_RW) ? 1 : -1];
+        (void)sizeof(Register_Must_Be_Writable);
+        
+        for (int i = 0; i < Register::Width; i++)
+        {
+            MPL_Stage_Byte((char)(Register::Address + i), (char)(Value >> (8 * (Register::Width - 1 - i))));
+        }
+    }
+
+    int MPL_Flush();  // Write every staged register. Dirty adjacent registers are merged into one auto-increment write. Ends the batch. Returns the number of I2C writes.
+
+#ifdef MPL3115A2_BUS_STATS
+    void MPL_Get_Bus_Stats(MPL_Bus_Stats &Stats);  // Snapshot of the bus counters since construction or the last MPL_Reset_Bus_Stats().
+
+    void MPL_Reset_Bus_Stats();  // Zero all bus counters.
+#endif
+
 
 
 private:
 
+    MPL3115A2(const MPL3115A2 &);             // Not copyable: the interrupt pin is owned and its handler bound to this instance.
+    MPL3115A2 &operator=(const MPL3115A2 &);
+
     I2C _i2c;
 
+    int MPL_Bus_Write(const char *data, int length, bool repeated = false);  // Every blocking transfer of the driver goes through these two. Plain forwarding to _i2c unless MPL3115A2_BUS_STATS is defined.
+
+    int MPL_Bus_Read(char *data, int length, bool repeated = false);
+
+#ifdef MPL3115A2_BUS_STATS
+    void MPL_Account_Transfer(int length, int Result, uint32_t Duration_us);  // One transfer into the per-register counters and the latency histogram.
+#endif
+
+    bool MPL_Wait_For_Conversion();  // Sleeps for the nominal conversion time, then one OST check (or waits for the Data Ready interrupt). Returns 'false' when the acquisition did not complete within MPL_CONVERSION_TIMEOUT conversion times.
+
+    void MPL_Route_Interrupt(char Source, bool Route_To_INT1);  // Enable one interrupt source (CTRL_REG4 bit, same position in CTRL_REG5), route it to INT1/INT2 and attach MPL_Data_Ready_ISR() to the active edge of int_pin.
+
+    void MPL_Decode_Sample(MPL_Sample &Sample);  // Reassembles Pressure/Altitude and Temperature from the Raw bytes of the sample.
+
+    void MPL_Data_Ready_ISR();  // Attached to int_pin. Only raises the Data_Ready flag (or starts the non-blocking read of an asynchronous sample), no blocking I2C traffic in the interrupt context.
+
+#if DEVICE_I2C_ASYNCH
+    void MPL_Async_Triggered(int Event);    // OST write completed. Wait for the conversion.
+    void MPL_Async_Converted();             // Conversion time elapsed (or Data Ready interrupt). Check OST and read.
+    void MPL_Async_Checked(int Event);      // CTRL_REG1 read completed. Read the sample or wait a bit longer.
+    void MPL_Async_Read(int Event);         // Burst read completed. Decode and report.
+    void MPL_Async_Finish(bool Success);
+#endif
+
+    void MPL_Write_Registers(const char *data, int length);  // data[0] is the first register address. Staged while a batch is open, otherwise one burst write.
+
+    void MPL_Read_Registers(char Address, char *data, int length);  // Staged bytes when all of them are pending in the open batch, otherwise one burst read.
+
+    void MPL_Stage_Byte(char Address, char Value);  // Read-only addresses are ignored.
+
+    void MPL_Apply_Register_Write(char Address, char Value);  // Keep the driver-side copies (CTRL_REGn shadow, F_SETUP, BAR_IN, OFF_H) coherent with a register write done by MPL_Flush().
+
+    char MPL_Read_Ctrl(char Register);  // Returns the shadow copy of CTRL_REGn. No I2C traffic unless the shadow has not been synchronized yet.
+
+    void MPL_Write_Ctrl(char Register, char Value);  // Single 2-byte write of CTRL_REGn. Keeps the shadow copy coherent.
+
     bool Bar_Mode;
     bool is_Reset;
+
+    char Ctrl_Shadow[5];  // Driver-side copy of CTRL_REG1..CTRL_REG5. Self-clearing bits (OST, RST) are never stored.
+    bool Shadow_Valid;    // 'false' until the shadow has been loaded from the device or set by a reset.
+    bool Shadow_Verify;   // Read back every control register write.
+
+    char FIFO_Setup;      // Last value written to F_SETUP.
+
+    char Staged[MPL_REGISTER_COUNT];  // Values waiting for MPL_Flush(), indexed by register address.
+    uint64_t Staged_Mask;             // Bit n set: register n is staged.
+    bool Batching;                    // Between MPL_Begin_Batch() and MPL_Flush().
+
+    uint32_t Bar_Reference_Pa;                  // BAR_IN in Pa, as written to the device.
+    int8_t Altitude_Trim;                       // OFF_H in m, as written to the device.
+    MPL_Altitude_Reference Altitude_Reference;  // Precomputed from Bar_Reference_Pa and Altitude_Trim. Refreshed whenever either changes.
+    bool Software_Altitude;                     // MPL_Get_Altitude() computes Altitude from Pressure.
+
+    InterruptIn *Int_Pin;          // NULL when the sensor interrupt pad is not wired.
+    bool Data_Ready_Mode;          // 'true' - MPL_Wait_For_Conversion() waits for the Data Ready interrupt instead of polling.
+    volatile bool Data_Ready;      // Set by MPL_Data_Ready_ISR(). Cleared when a new acquisition is triggered.
+    volatile uint32_t Data_Ready_us;  // us_ticker at the last sensor interrupt.
+    uint32_t Trigger_us;           // us_ticker at the last OST trigger.
+    uint32_t Active_us;            // us_ticker when MPL_Start_Continuous() entered ACTIVE mode: origin of the sample time grid.
+    bool Active_Known;             // Active_us is valid: ACTIVE mode was entered by this driver.
+
+    bool Low_Power_FIFO;           // MPL_Sleep_Until_Samples() drains the FIFO instead of reading OUT_P/OUT_T.
+    uint32_t Low_Power_Step_us;    // ACTIVE mode time step, for the timeout and the deep sleep time base.
+    uint32_t Low_Power_Wake_us;    // us_ticker at the last wake-up.
+    MPL_Duty_Cycle Duty;
+
+    MPL_Sleep_Timer Sleeper;       // Sleeps the core through the conversion window, until the interrupt or the timeout.
+
+#if DEVICE_I2C_ASYNCH
+    Timeout Async_Timer;           // Fires once the expected conversion time has elapsed.
+    MPL_Sample *Async_Sample;      // Caller buffer of the sample in progress.
+    Callback<void(bool)> Async_Done;
+    char Async_Buffer[2];          // Outgoing/incoming bytes of the transfer in progress. Must outlive the call that started it.
+    volatile char Async_State;     // MPL_ASYNC_IDLE, _TRIGGER, _CONVERT, _CHECK or _READ.
+#endif
+    
+#ifdef MPL3115A2_BUS_STATS
+    MPL_Bus_Stats Bus_Stats;
+    char Bus_Stats_Register;       // Register pointer as last written, for accounting the reads that follow.
+#endif
     
     static const uint32_t frequency  = 400000;
 
@@ -0,0 +1,142 @@
+#include "MPL3115A2_Kalman.h"
+
+
+MPL3115A2_Kalman::MPL3115A2_Kalman(int32_t Altitude_Noise, int32_t Acceleration_Noise)
+{
+    Set_Altitude_Noise(Altitude_Noise);
+    
+    Q = ((int64_t)Acceleration_Noise * Acceleration_Noise) << 16;   // Q16.4 squared is Q.8, Q.24 is 16 bits more.
+    
+    Reset();
+}
+
+void MPL3115A2_Kalman::Set_Altitude_Noise(int32_t Altitude_Noise)  // After a change of the oversampling ratio. Q16.4 m.
+{
+    R = ((int64_t)Altitude_Noise * Altitude_Noise) << 16;
+    
+    if (R == 0)
+    {
+        R = 1;   // Keeps the divisions defined. A noiseless sensor is trusted completely.
+    }
+}
+
+void MPL3115A2_Kalman::Reset()  // Forget the state. The next sample starts the filter again.
+{
+    H = 0;
+    V = 0;
+    P00 = 0;
+    P01 = 0;
+    P11 = 0;
+    Last_Altitude = 0;
+    Last_Time_us = 0;
+    Initialized = false;
+}
+
+void MPL3115A2_Kalman::Update(const MPL_Sample &Sample)  // Predict to the time of the sample and correct with its altitude.
+{
+    uint32_t Now_us = Sample.Timestamp_us;
+    
+    if (Initialized == false)
+    {
+        H = Sample.Altitude_Fixed * 256;   // Q16.4 to Q.12
+        V = 0;
+        P00 = R;
+        P01 = 0;
+        P11 = (int64_t)100 << 24;   // Vertical speed unknown: (10 m/s)^2
+        Initialized = true;
+    }
+    
+    else
+    {
+        Predict(Now_us - Last_Time_us);   // Wraps correctly on the 32-bit ticker.
+        Correct_Altitude(Sample.Altitude_Fixed * 256);
+    }
+    
+    Last_Altitude = Sample.Altitude_Fixed;
+    Last_Time_us = Now_us;
+}
+
+void MPL3115A2_Kalman::Update(const MPL_Frame &Frame, uint32_t Step_us)  // Same, plus the delta registers when conversions were missed since the previous update.
+{
+    // The delta registers hold the change since the previous conversion. When every conversion is read, that is
+    // exactly the difference of two consecutive measurements and adds nothing. When conversions were missed, it is
+    // the slope at the end of the gap, which the altitude alone does not show: use it as a vertical speed measurement.
+    bool Missed = (Initialized == true) && (Step_us != 0) && ((Frame.Current.Altitude_Fixed - Frame.Altitude_Change_Fixed) != Last_Altitude);
+    
+    Update(Frame.Current);
+    
+    if (Missed == true)
+    {
+        int32_t Speed_Q12 = (int32_t)(((int64_t)Frame.Altitude_Change_Fixed * 256) * 1000000 / Step_us);
+        int64_t Speed_Var_Q24 = 2 * R * 1000000 / Step_us * 1000000 / Step_us;   // Difference of two samples over one step.
+        
+        Correct_Speed(Speed_Q12, Speed_Var_Q24);
+    }
+}
+
+void MPL3115A2_Kalman::Predict(uint32_t Elapsed_us)  // Constant-velocity model over Elapsed_us.
+{
+    if (Elapsed_us > MPL_KALMAN_MAX_STEP_US)
+    {
+        Elapsed_us = MPL_KALMAN_MAX_STEP_US;
+    }
+    
+    int64_t Dt = ((int64_t)Elapsed_us << 16) / 1000000;   // Seconds, Q.16
+    
+    H += (int32_t)(((int64_t)V * Elapsed_us) / 1000000);
+    
+    // P = F P F' + G Q G', F = [1 dt; 0 1], G = [dt^2/2; dt]
+    int64_t Q_Dt2 = (((Q * Dt) >> 16) * Dt) >> 16;           // Q dt^2
+    int64_t Q_Dt3 = (Q_Dt2 * Dt) >> 16;                      // Q dt^3
+    int64_t Q_Dt4 = (Q_Dt3 * Dt) >> 16;                      // Q dt^4
+    int64_t Dt_P11 = (P11 * Dt) >> 16;
+    
+    P00 += ((Dt * (2 * P01 + Dt_P11)) >> 16) + (Q_Dt4 >> 2);
+    P01 += Dt_P11 + (Q_Dt3 >> 1);
+    P11 += Q_Dt2;
+}
+
+void MPL3115A2_Kalman::Correct_Altitude(int32_t Altitude_Q12)  // Scalar update, H = [1 0]. Two divisions, no loops.
+{
+    int64_t S = P00 + R;
+    int64_t K0 = (P00 << 16) / S;   // Q.16
+    int64_t K1 = (P01 << 16) / S;   // Q.16, 1/s
+    int64_t Innovation = (int64_t)Altitude_Q12 - H;
+    
+    H += (int32_t)((K0 * Innovation) >> 16);
+    V += (int32_t)((K1 * Innovation) >> 16);
+    
+    P11 -= (K1 * P01) >> 16;   // Uses the old P01
+    P01 -= (K0 * P01) >> 16;
+    P00 -= (K0 * P00) >> 16;
+}
+
+void MPL3115A2_Kalman::Correct_Speed(int32_t Speed_Q12, int64_t Speed_Var_Q24)  // Scalar update, H = [0 1]. Two divisions, no loops.
+{
+    int64_t S = P11 + Speed_Var_Q24;
+    int64_t K0 = (P01 << 16) / S;   // Q.16, s
+    int64_t K1 = (P11 << 16) / S;   // Q.16
+    int64_t Innovation = (int64_t)Speed_Q12 - V;
+    
+    H += (int32_t)((K0 * Innovation) >> 16);
+    V += (int32_t)((K1 * Innovation) >> 16);
+    
+    P00 -= (K0 * P01) >> 16;   // Uses the old P01
+    P01 -= (K0 * P11) >> 16;
+    P11 -= (K1 * P11) >> 16;
+}
+
+bool MPL3115A2_Kalman::Ready()  // 'true' once a sample has been seen.
+{
+    return Initialized;
+}
+
+int32_t MPL3115A2_Kalman::Altitude()  // Filtered altitude, Q16.4 m
+{
+    return (H + 128) >> 8;
+}
+
+int32_t MPL3115A2_Kalman::Vertical_Speed()  // Filtered vertical speed, Q16.4 m/s
+{
+    return (V + 128) >> 8;
+}
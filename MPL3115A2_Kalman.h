@@ -0,0 +1,52 @@
+#include "mbed.h"
+#ifndef MPL3115A2_KALMAN_H_
+#define MPL3115A2_KALMAN_H_
+
+#include "MPL3115A2_IO.h"
+
+#define MPL_KALMAN_MAX_STEP_US 4000000   // Longest prediction step. Longer gaps are predicted as 4 s, the covariance still grows enough to accept the new altitude.
+
+class MPL3115A2_Kalman   // Integer-only constant-velocity Kalman filter: altitude and vertical speed from the altitude of every sample and, when conversions were missed, the delta registers.
+{
+
+public:
+
+    MPL3115A2_Kalman(int32_t Altitude_Noise, int32_t Acceleration_Noise);  // Altitude_Noise: standard deviation of one sample, Q16.4 m (depends on the OSR). Acceleration_Noise: standard deviation of the vertical acceleration, Q16.4 m/s^2.
+
+    void Set_Altitude_Noise(int32_t Altitude_Noise);  // After a change of the oversampling ratio. Q16.4 m.
+
+    void Reset();  // Forget the state. The next sample starts the filter again.
+
+    void Update(const MPL_Sample &Sample);  // Predict to Sample.Timestamp_us and correct with Sample.Altitude_Fixed. Both modes.
+
+    void Update(const MPL_Frame &Frame, uint32_t Step_us);  // Same, plus the delta registers when conversions were missed since the previous update. Step_us: time between two conversions (ACTIVE mode time step).
+
+    bool Ready();  // 'true' once a sample has been seen.
+
+    int32_t Altitude();  // Filtered altitude, Q16.4 m
+
+    int32_t Vertical_Speed();  // Filtered vertical speed, Q16.4 m/s. Positive when climbing.
+
+private:
+
+    void Predict(uint32_t Elapsed_us);  // Constant-velocity model over Elapsed_us.
+
+    void Correct_Altitude(int32_t Altitude_Q12);  // Scalar update, H = [1 0].
+
+    void Correct_Speed(int32_t Speed_Q12, int64_t Speed_Var_Q24);  // Scalar update, H = [0 1].
+
+    // State in Q.12 (1/4096 m, 1/4096 m/s), covariance in Q.24 of the same units.
+    int32_t H;
+    int32_t V;
+    int64_t P00, P01, P11;
+
+    int64_t R;   // Altitude noise variance, Q.24 m^2
+    int64_t Q;   // Acceleration noise variance, Q.24 m^2/s^4
+
+    int32_t Last_Altitude;   // Q16.4, last measurement
+    uint32_t Last_Time_us;
+    bool Initialized;
+
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "MPL3115A2_Log.h"
+
+
+MPL3115A2_Log::MPL3115A2_Log(FILE *File)
+{
+    this->File = File;
+
+    Used = 0;
+    Sequence = 0;
+    Block_Samples = 0;
+
+    Sample_Count = 0;
+    Block_Count = 0;
+    Byte_Count = 0;
+    Error_Count = 0;
+}
+
+bool MPL3115A2_Log::Write(const MPL_Sample &Sample)  // Append one sample, delta coded against the previous one.
+{
+    bool Written = true;
+
+    // A new block starts when the open one could not take a record of the worst size, when the mode changes (the
+    // header carries it) or when the time would leave the range of the block: backwards, or beyond int32_t in us.
+    if (Used != 0)
+    {
+        bool Mode_Changed = (Sample.Bar_Mode != ((Block[3] & MPL_LOG_FLAG_BAR_MODE) != 0));
+        bool Out_Of_Span = ((int32_t)(Sample.Timestamp_us - Previous_us) < 0) || ((Sample.Timestamp_us - First_us) > MPL_LOG_MAX_SPAN_US);
+
+        if (((Used + MPL_LOG_MAX_RECORD_BYTES) > MPL_LOG_BLOCK_BYTES) || (Block_Samples == 0xFFFF) || Mode_Changed || Out_Of_Span)
+        {
+            Written = Flush();
+        }
+    }
+
+    Sample_Count++;
+
+    if (Used == 0)
+    {
+        Start_Block(Sample);
+        return Written;
+    }
+
+    uint32_t Pressure = MPL_Log_Pressure_Field(&Sample.Raw[0]);
+    uint32_t Temperature = MPL_Log_Temperature_Field(&Sample.Raw[3]);
+    uint32_t Units = (Sample.Timestamp_us - First_us) / MPL_LOG_TIME_UNIT_US;   // From the block start, not from the previous sample: rounding does not add up.
+    uint32_t Step = Units - Previous_Units;
+
+    Used += MPL_Log_Put_Varint(&Block[Used], MPL_Log_Zigzag(MPL_Log_Wrap(Pressure - Previous_Pressure, 20)));
+    Used += MPL_Log_Put_Varint(&Block[Used], MPL_Log_Zigzag(MPL_Log_Wrap(Temperature - Previous_Temperature, 12)));
+    Used += MPL_Log_Put_Varint(&Block[Used], MPL_Log_Zigzag((int32_t)(Step - Previous_Step)));   // 0 on a regular time step.
+
+    Previous_us = Sample.Timestamp_us;
+    Previous_Pressure = Pressure;
+    Previous_Temperature = Temperature;
+    Previous_Units = Units;
+    Previous_Step = Step;
+    Block_Samples++;
+
+    return Written;
+}
+
+int MPL3115A2_Log::Write(const MPL_Sample *Samples, int Count)  // Append a batch. Stops at the first write failure.
+{
+    for (int i = 0; i < Count; i++)
+    {
+        if (Write(Samples[i]) == false)
+        {
+            return i + 1;   // The sample itself went into the new block.
+        }
+    }
+
+    return Count;
+}
+
+bool MPL3115A2_Log::Flush()  // Complete the header and write the block in one call.
+{
+    if (Used == 0)
+    {
+        return true;
+    }
+
+    int Payload_Length = Used - MPL_LOG_HEADER_BYTES;
+
+    MPL_Log_Put_16(&Block[6], Block_Samples);
+    MPL_Log_Put_16(&Block[8], (uint32_t)Payload_Length);
+    MPL_Log_Put_32(&Block[MPL_LOG_CRC_OFFSET], MPL_Log_CRC_Block(Block, Payload_Length));
+
+    bool Written = (fwrite(Block, 1, Used, File) == (size_t)Used) && (fflush(File) == 0);   // fflush: on LocalFileSystem a block is on the disk once this returns.
+
+    if (Written)
+    {
+        Block_Count++;
+        Byte_Count += Used;
+    }
+
+    else
+    {
+        Error_Count++;
+    }
+
+    Sequence++;   // Also after a failure: the reader sees the gap.
+    Used = 0;
+
+    return Written;
+}
+
+void MPL3115A2_Log::Start_Block(const MPL_Sample &Sample)  // The first sample goes into the header as absolute values.
+{
+    Previous_Pressure = MPL_Log_Pressure_Field(&Sample.Raw[0]);
+    Previous_Temperature = MPL_Log_Temperature_Field(&Sample.Raw[3]);
+    First_us = Sample.Timestamp_us;
+    Previous_us = Sample.Timestamp_us;
+    Previous_Units = 0;
+    Previous_Step = 0;
+    Block_Samples = 1;
+
+    Block[0] = (char)MPL_LOG_MAGIC_0;
+    Block[1] = (char)MPL_LOG_MAGIC_1;
+    Block[2] = MPL_LOG_VERSION;
+    Block[3] = Sample.Bar_Mode ? MPL_LOG_FLAG_BAR_MODE : 0;
+    MPL_Log_Put_16(&Block[4], Sequence);
+    MPL_Log_Put_32(&Block[10], First_us);
+    MPL_Log_Put_Fields(&Block[14], Previous_Pressure, Previous_Temperature);
+    Block[19] = 0;
+
+    Used = MPL_LOG_HEADER_BYTES;   // Count, payload length and CRC are filled in by Flush().
+}
+
+uint32_t MPL3115A2_Log::Samples()
+{
+    return Sample_Count;
+}
+
+uint32_t MPL3115A2_Log::Blocks()
+{
+    return Block_Count;
+}
+
+uint32_t MPL3115A2_Log::Bytes()
+{
+    return Byte_Count;
+}
+
+uint32_t MPL3115A2_Log::Errors()
+{
+    return Error_Count;
+}
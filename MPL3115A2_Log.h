@@ -0,0 +1,51 @@
+#include "mbed.h"
+#ifndef MPL3115A2_LOG_H_
+#define MPL3115A2_LOG_H_
+
+#include <stdio.h>
+#include "MPL3115A2_IO.h"
+#include "MPL3115A2_Log_Format.h"
+
+class MPL3115A2_Log   // Streaming writer of the compact block log of MPL3115A2_Log_Format.h. Samples are delta coded into a RAM block; the file sees one write per block.
+{
+
+public:
+
+    MPL3115A2_Log(FILE *File);  // Open in binary mode, e.g. LocalFileSystem Local("local"); fopen("/local/mpl.log", "ab"). Appending to an existing log is fine: every block stands alone.
+
+    bool Write(const MPL_Sample &Sample);  // Append one sample. Returns 'false' when a full block had to be written and the write failed: that block is lost, the sample is kept.
+
+    int Write(const MPL_Sample *Samples, int Count);  // Append the samples of MPL_Drain_FIFO() or MPL_Sleep_Until_Samples(). Stops at the first write failure and returns the samples taken so far, the one that hit it included.
+
+    bool Flush();  // Write the current block now, e.g. before power down. The next sample starts a new block. Returns 'false' when the write failed.
+
+    uint32_t Samples();   // Samples appended since construction
+    uint32_t Blocks();    // Blocks written to the file: file writes
+    uint32_t Bytes();     // Bytes written to the file
+    uint32_t Errors();    // Blocks lost to write failures
+
+private:
+
+    void Start_Block(const MPL_Sample &Sample);  // Header fields and delta references from the first sample.
+
+    FILE *File;
+    char Block[MPL_LOG_BLOCK_BYTES];
+    int Used;                    // Header plus payload bytes. 0: no block open.
+    uint16_t Sequence;
+    uint16_t Block_Samples;
+
+    uint32_t First_us;           // Timestamp of the first sample of the block
+    uint32_t Previous_us;
+    uint32_t Previous_Pressure;  // 20-bit field
+    uint32_t Previous_Temperature;  // 12-bit field
+    uint32_t Previous_Units;     // Time units since First_us
+    uint32_t Previous_Step;      // Time units between the last two samples
+
+    uint32_t Sample_Count;
+    uint32_t Block_Count;
+    uint32_t Byte_Count;
+    uint32_t Error_Count;
+
+};
+
+#endif
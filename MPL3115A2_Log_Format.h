@@ -0,0 +1,173 @@
+/*!
+ *   Block format of the compact MPL3115A2 sample log, shared by the writer (MPL3115A2_Log.h) and the
+ *   host reader (host/MPL3115A2_Log_Reader.h).
+ *
+ *   A log is a sequence of independent blocks of at most MPL_LOG_BLOCK_BYTES:
+ *
+ *      Offset  Size  Field
+ *      0       2     Magic 0xB5 0x4D
+ *      2       1     Version (MPL_LOG_VERSION)
+ *      3       1     Flags: MPL_LOG_FLAG_BAR_MODE when the samples were converted in Barometer mode
+ *      4       2     Sequence number, +1 per block, wraps
+ *      6       2     Samples in the block, including the first one
+ *      8       2     Payload bytes after the header
+ *      10      4     Timestamp_us of the first sample
+ *      14      5     First sample: P_MSB, P_CSB, P_LSB, T_MSB, T_LSB (reserved low nibbles cleared)
+ *      19      1     Reserved, 0
+ *      20      4     CRC-32 (IEEE 802.3) of bytes 0..19 and of the payload
+ *
+ *   Multi-byte header fields are little-endian. The header is an absolute resync point: a reader that
+ *   meets a damaged block skips it and carries on with the next valid header.
+ *
+ *   Every further sample is one payload record of three varints (7 bits per byte, LSB group first,
+ *   bit 7 set on all bytes but the last) holding zigzag-coded differences against the previous sample:
+ *
+ *      P   the 20-bit pressure/altitude field, modulo 2^20
+ *      T   the 12-bit temperature field, modulo 2^12
+ *      t   second difference of the time in MPL_LOG_TIME_UNIT_US since the first sample of the block
+ *
+ *   Pressure and temperature are lossless. Times are exact in the header and within one time unit after it,
+ *   without drift along the block. A steady sensor gives 1 byte per field: 3 bytes per sample.
+ *
+*/
+
+#ifndef MPL3115A2_LOG_FORMAT_H_
+#define MPL3115A2_LOG_FORMAT_H_
+
+#include <stdint.h>    // to handle uintN_t and intN_t integer types
+
+#ifndef MPL_LOG_BLOCK_BYTES
+#define MPL_LOG_BLOCK_BYTES 512      // Header included. One file write per block. [MPL_LOG_HEADER_BYTES + MPL_LOG_MAX_RECORD_BYTES, 65535]
+#endif
+
+#define MPL_LOG_MAGIC_0          0xB5
+#define MPL_LOG_MAGIC_1          0x4D   // 'M'
+#define MPL_LOG_VERSION          1
+#define MPL_LOG_FLAG_BAR_MODE    0x01
+#define MPL_LOG_HEADER_BYTES     24
+#define MPL_LOG_CRC_OFFSET       20
+#define MPL_LOG_MAX_RECORD_BYTES 12     // P: 3, T: 2, t: 5 varint bytes at most, rounded up.
+#define MPL_LOG_TIME_UNIT_US     1000   // Resolution of the per-sample times.
+#define MPL_LOG_MAX_SPAN_US      0x7FFFFFFFUL   // A block never covers more: time differences stay in int32_t.
+
+static inline uint32_t MPL_Log_Pressure_Field(const char *Raw)     // {MSB, CSB, LSB[7:4]}, unsigned 20-bit, whatever the mode.
+{
+    return ((uint32_t)(uint8_t)Raw[0] << 12) | ((uint32_t)(uint8_t)Raw[1] << 4) | ((uint32_t)(uint8_t)Raw[2] >> 4);
+}
+
+static inline uint32_t MPL_Log_Temperature_Field(const char *Raw)  // {MSB, LSB[7:4]}, unsigned 12-bit.
+{
+    return ((uint32_t)(uint8_t)Raw[0] << 4) | ((uint32_t)(uint8_t)Raw[1] >> 4);
+}
+
+static inline void MPL_Log_Put_Fields(char *Raw, uint32_t Pressure_Field, uint32_t Temperature_Field)  // Inverse of the two above: 5 raw bytes.
+{
+    Raw[0] = (char)(Pressure_Field >> 12);
+    Raw[1] = (char)(Pressure_Field >> 4);
+    Raw[2] = (char)((Pressure_Field & 0x0F) << 4);
+    Raw[3] = (char)(Temperature_Field >> 4);
+    Raw[4] = (char)((Temperature_Field & 0x0F) << 4);
+}
+
+static inline int32_t MPL_Log_Wrap(uint32_t Difference, int Bits)  // Difference of two Bits-wide fields, sign-extended: the shortest way round.
+{
+    uint32_t Mask = (1UL << Bits) - 1;
+    uint32_t Sign = 1UL << (Bits - 1);
+
+    Difference &= Mask;
+
+    return (int32_t)((Difference & Sign) ? (Difference | ~Mask) : Difference);
+}
+
+static inline uint32_t MPL_Log_Zigzag(int32_t Value)  // 0, -1, 1, -2 ... -> 0, 1, 2, 3 ...: small magnitudes of either sign give small codes.
+{
+    return ((uint32_t)Value << 1) ^ (uint32_t)(Value >> 31);
+}
+
+static inline int32_t MPL_Log_Unzigzag(uint32_t Code)
+{
+    return (int32_t)((Code >> 1) ^ (0 - (Code & 1)));
+}
+
+static inline int MPL_Log_Put_Varint(char *Out, uint32_t Value)  // Returns the number of bytes written: 1 .. 5.
+{
+    int Length = 0;
+
+    while (Value >= 0x80)
+    {
+        Out[Length++] = (char)((Value & 0x7F) | 0x80);
+        Value >>= 7;
+    }
+
+    Out[Length++] = (char)Value;
+
+    return Length;
+}
+
+static inline int MPL_Log_Get_Varint(const char *In, int Available, uint32_t &Value)  // Returns the number of bytes read, 0 when the varint is truncated or longer than 5 bytes.
+{
+    Value = 0;
+
+    for (int i = 0; (i < Available) && (i < 5); i++)
+    {
+        Value |= (uint32_t)((uint8_t)In[i] & 0x7F) << (7 * i);
+
+        if (((uint8_t)In[i] & 0x80) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+static inline uint32_t MPL_Log_CRC32(uint32_t CRC, const char *Data, int Length)  // Reflected 0xEDB88320, 4 bits per step: a 64-byte table instead of 1 KB. Start and end with ~0 (see MPL_Log_CRC_Block).
+{
+    static const uint32_t Table[16] =
+    {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    for (int i = 0; i < Length; i++)
+    {
+        CRC ^= (uint8_t)Data[i];
+        CRC = (CRC >> 4) ^ Table[CRC & 0x0F];
+        CRC = (CRC >> 4) ^ Table[CRC & 0x0F];
+    }
+
+    return CRC;
+}
+
+static inline uint32_t MPL_Log_CRC_Block(const char *Block, int Payload_Length)  // CRC of a whole block: header without its CRC field, then the payload.
+{
+    uint32_t CRC = MPL_Log_CRC32(0xFFFFFFFFUL, Block, MPL_LOG_CRC_OFFSET);
+
+    return ~MPL_Log_CRC32(CRC, &Block[MPL_LOG_HEADER_BYTES], Payload_Length);
+}
+
+static inline void MPL_Log_Put_16(char *Out, uint32_t Value)
+{
+    Out[0] = (char)Value;
+    Out[1] = (char)(Value >> 8);
+}
+
+static inline void MPL_Log_Put_32(char *Out, uint32_t Value)
+{
+    Out[0] = (char)Value;
+    Out[1] = (char)(Value >> 8);
+    Out[2] = (char)(Value >> 16);
+    Out[3] = (char)(Value >> 24);
+}
+
+static inline uint32_t MPL_Log_Get_16(const char *In)
+{
+    return (uint32_t)(uint8_t)In[0] | ((uint32_t)(uint8_t)In[1] << 8);
+}
+
+static inline uint32_t MPL_Log_Get_32(const char *In)
+{
+    return (uint32_t)(uint8_t)In[0] | ((uint32_t)(uint8_t)In[1] << 8) | ((uint32_t)(uint8_t)In[2] << 16) | ((uint32_t)(uint8_t)In[3] << 24);
+}
+
+#endif
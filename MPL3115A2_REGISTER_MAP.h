@@ -82,6 +82,22 @@
 #define DR_PDR  0x04  // Pressure/Altitude data ready. New aquisition is availble for reading. Cleared anytime OUT_P_MSB is read.
 #define DR_TDR  0x02  // Temperature data ready. New aquisition is availble for reading. Cleared anytime OUT_T_MSB is read.
 
+//--- F_STATUS Register [FIFO Status. Cleared by reading F_STATUS] ---
+
+#define F_STATUS_F_OVF       0x80  // FIFO overflow. '1' - at least one sample was lost (circular mode) or the FIFO stopped accepting samples (stop mode).
+#define F_STATUS_F_WMRK_FLAG 0x40  // FIFO watermark event. '1' - the sample count F_CNT reached the watermark F_WMRK.
+#define F_STATUS_F_CNT       0x3F  // FIFO sample counter [5:0]. Number of Pressure/Altitude + Temperature samples stored, 0 to 32.
+
+//--- F_SETUP Register [FIFO Setup. F_MODE must be set to '00' before switching between two non-zero modes] ---
+
+#define F_SETUP_F_MODE_DISABLED 0x00  // FIFO disabled. OUT_P/OUT_T contain the most recent sample.
+#define F_SETUP_F_MODE_CIRCULAR 0x40  // Circular buffer. The oldest sample is discarded on overflow. TIME_DLY counts the time since the overflow.
+#define F_SETUP_F_MODE_STOP     0x80  // Stop accepting new samples on overflow.
+#define F_SETUP_F_WMRK          0x3F  // FIFO watermark [5:0]. '0' - watermark event disabled.
+
+#define F_DEPTH        32  // Number of samples held by the on-chip FIFO.
+#define F_SAMPLE_BYTES 5   // Bytes per FIFO sample read through F_DATA: P_MSB, P_CSB, P_LSB, T_MSB, T_LSB.
+
 //--- SYSMOD Register [Current Operating Mode] ---
 
 #define SYSMOD_ACTIVE  0x01  // If not ACTIVE then the device is in STANDBY mode
@@ -121,8 +137,27 @@
 #define CTRL_REG1_RAW    0x40  // RAW output mode. Direct ADC readings. Uncompensated.
 #define CTRL_REG1_ALT    0x80  // Altimeter/Barometer Mode. '1'- Altimeter Mode and '0' - Barometer Mode. 
 
+// Conversion time of one acquisition per oversampling ratio: the minimum times above, in microseconds. Single source for
+// MPL3115A2::MPL_Conversion_Time_us(), the MPL3115A2T traits and the adaptive controller.
+#define MPL_CONVERSION_TIME_OS1_US   6000
+#define MPL_CONVERSION_TIME_OS2_US   10000
+#define MPL_CONVERSION_TIME_OS4_US   18000
+#define MPL_CONVERSION_TIME_OS8_US   34000
+#define MPL_CONVERSION_TIME_OS16_US  66000
+#define MPL_CONVERSION_TIME_OS32_US  130000
+#define MPL_CONVERSION_TIME_OS64_US  258000
+#define MPL_CONVERSION_TIME_OS128_US 512000
+
+static const long MPL_Conversion_Time_Table_us[8] =   // Indexed by OS[5:3]: (CTRL_REG1 & CTRL_REG1_OS_128) >> 3
+{
+    MPL_CONVERSION_TIME_OS1_US,  MPL_CONVERSION_TIME_OS2_US,  MPL_CONVERSION_TIME_OS4_US,  MPL_CONVERSION_TIME_OS8_US,
+    MPL_CONVERSION_TIME_OS16_US, MPL_CONVERSION_TIME_OS32_US, MPL_CONVERSION_TIME_OS64_US, MPL_CONVERSION_TIME_OS128_US
+};
+
 //--- CTRL_REG2 Register ---
 
+#define CTRL_REG2_ST          0x0F  // Auto acquisition time step ST[3:0] in ACTIVE mode. The period between samples is 2^ST seconds: 1 s to 32768 s (9.1 h).
+
 #define CTRL_REG2_ALARM_SEL   0x10  // Selects target value for SRC_PW/SRC_TW and SRC_PTH/SRC_TTH. '0' - values in P_TGT_MSB, P_TGT_LSB and T_TGT are used. 
                                     // '1' -  values in OUT_P/OUT_T are used for calculation interrupts SRC_PW/SRC_TW and SRC_PTH/SRC_TTH.
 
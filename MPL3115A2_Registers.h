@@ -0,0 +1,102 @@
+/*!
+ *   Typed description of the MPL3115A2 register fields, on top of the addresses of MPL3115A2_REGISTER_MAP.h.
+ *
+ *   Every multi-byte field (BAR_IN, P_TGT, P_MIN ...) is one type that carries its first address, its width
+ *   in bytes (big-endian, MSB first), its access and its reset value as compile-time constants:
+ *
+ *      MPL_Reg_BAR_IN::Address == BAR_IN_MSB, MPL_Reg_BAR_IN::Width == 2, MPL_Reg_BAR_IN::Reset == 0xC5E7
+ *
+ *   MPL3115A2::MPL_Stage<MPL_Reg_P_TGT>(Value) uses them to check at compile time that the field is writable
+ *   and to split the value into bytes. MPL_Register_Table lists the same fields for code that walks the map.
+ *
+*/
+
+#ifndef MPL3115A2_REGISTERS_H_
+#define MPL3115A2_REGISTERS_H_
+
+#include <stdint.h>    // to handle uintN_t and intN_t integer types
+#include "MPL3115A2_REGISTER_MAP.h"
+
+#define MPL_ACCESS_R  0x01   // Read only
+#define MPL_ACCESS_RW 0x03   // Read/Write
+
+#define MPL_REGISTER_COUNT (OFF_H + 1)   // STATUS (0x00) .. OFF_H (0x2D)
+
+#define MPL_REGISTER(Name, First_Address, Field_Width, Field_Access, Reset_Value)                                                           \
+    struct MPL_Reg_##Name { enum { Address = First_Address, Width = Field_Width, Access = Field_Access }; static const uint32_t Reset = Reset_Value; };
+
+//            Name          Address           Width  Access          Reset
+MPL_REGISTER( STATUS,       STATUS,           1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( OUT_P,        OUT_P_MSB,        3,     MPL_ACCESS_R,   0x000000 )
+MPL_REGISTER( OUT_T,        OUT_T_MSB,        2,     MPL_ACCESS_R,   0x0000   )
+MPL_REGISTER( DR_STATUS,    DR_STATUS,        1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( OUT_P_DELTA,  OUT_P_DELTA_MSB,  3,     MPL_ACCESS_R,   0x000000 )
+MPL_REGISTER( OUT_T_DELTA,  OUT_T_DELTA_MSB,  2,     MPL_ACCESS_R,   0x0000   )
+MPL_REGISTER( WHO_AM_I,     WHO_AM_I,         1,     MPL_ACCESS_R,   0xC4     )
+MPL_REGISTER( F_STATUS,     F_STATUS,         1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( F_DATA,       F_DATA,           1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( F_SETUP,      F_SETUP,          1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( TIME_DLY,     TIME_DLY,         1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( SYSMOD,       SYSMOD,           1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( INT_SOURCE,   INT_SOURCE,       1,     MPL_ACCESS_R,   0x00     )
+MPL_REGISTER( PT_DATA_CFG,  PT_DATA_CFG,      1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( BAR_IN,       BAR_IN_MSB,       2,     MPL_ACCESS_RW,  0xC5E7   )
+MPL_REGISTER( P_TGT,        P_TGT_MSB,        2,     MPL_ACCESS_RW,  0x0000   )
+MPL_REGISTER( T_TGT,        T_TGT,            1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( P_WND,        P_WND_MSB,        2,     MPL_ACCESS_RW,  0x0000   )
+MPL_REGISTER( T_WND,        T_WND,            1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( P_MIN,        P_MIN_MSB,        3,     MPL_ACCESS_RW,  0x000000 )
+MPL_REGISTER( T_MIN,        T_MIN_MSB,        2,     MPL_ACCESS_RW,  0x0000   )
+MPL_REGISTER( P_MAX,        P_MAX_MSB,        3,     MPL_ACCESS_RW,  0x000000 )
+MPL_REGISTER( T_MAX,        T_MAX_MSB,        2,     MPL_ACCESS_RW,  0x0000   )
+MPL_REGISTER( CTRL_REG1,    CTRL_REG1,        1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( CTRL_REG2,    CTRL_REG2,        1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( CTRL_REG3,    CTRL_REG3,        1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( CTRL_REG4,    CTRL_REG4,        1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( CTRL_REG5,    CTRL_REG5,        1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( OFF_P,        OFF_P,            1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( OFF_T,        OFF_T,            1,     MPL_ACCESS_RW,  0x00     )
+MPL_REGISTER( OFF_H,        OFF_H,            1,     MPL_ACCESS_RW,  0x00     )
+
+#undef MPL_REGISTER
+
+struct MPL_Register_Info   // Run-time copy of one field description.
+{
+    char Address;
+    char Width;
+    char Access;
+    uint32_t Reset;
+};
+
+#define MPL_REGISTER_INFO(Name) { MPL_Reg_##Name::Address, MPL_Reg_##Name::Width, MPL_Reg_##Name::Access, MPL_Reg_##Name::Reset }
+
+static const MPL_Register_Info MPL_Register_Table[] =   // In address order, covers 0x00..0x2D without gaps.
+{
+    MPL_REGISTER_INFO(STATUS),      MPL_REGISTER_INFO(OUT_P),       MPL_REGISTER_INFO(OUT_T),       MPL_REGISTER_INFO(DR_STATUS),
+    MPL_REGISTER_INFO(OUT_P_DELTA), MPL_REGISTER_INFO(OUT_T_DELTA), MPL_REGISTER_INFO(WHO_AM_I),    MPL_REGISTER_INFO(F_STATUS),
+    MPL_REGISTER_INFO(F_DATA),      MPL_REGISTER_INFO(F_SETUP),     MPL_REGISTER_INFO(TIME_DLY),    MPL_REGISTER_INFO(SYSMOD),
+    MPL_REGISTER_INFO(INT_SOURCE),  MPL_REGISTER_INFO(PT_DATA_CFG), MPL_REGISTER_INFO(BAR_IN),      MPL_REGISTER_INFO(P_TGT),
+    MPL_REGISTER_INFO(T_TGT),       MPL_REGISTER_INFO(P_WND),       MPL_REGISTER_INFO(T_WND),       MPL_REGISTER_INFO(P_MIN),
+    MPL_REGISTER_INFO(T_MIN),       MPL_REGISTER_INFO(P_MAX),       MPL_REGISTER_INFO(T_MAX),       MPL_REGISTER_INFO(CTRL_REG1),
+    MPL_REGISTER_INFO(CTRL_REG2),   MPL_REGISTER_INFO(CTRL_REG3),   MPL_REGISTER_INFO(CTRL_REG4),   MPL_REGISTER_INFO(CTRL_REG5),
+    MPL_REGISTER_INFO(OFF_P),       MPL_REGISTER_INFO(OFF_T),       MPL_REGISTER_INFO(OFF_H)
+};
+
+#undef MPL_REGISTER_INFO
+
+#define MPL_REGISTER_TABLE_SIZE (sizeof(MPL_Register_Table) / sizeof(MPL_Register_Table[0]))
+
+static inline bool MPL_Register_Is_Writable(char Address)  // Byte-level lookup in MPL_Register_Table.
+{
+    for (unsigned i = 0; i < MPL_REGISTER_TABLE_SIZE; i++)
+    {
+        if (((unsigned char)Address >= (unsigned char)MPL_Register_Table[i].Address) && ((unsigned char)Address < (unsigned char)(MPL_Register_Table[i].Address + MPL_Register_Table[i].Width)))
+        {
+            return (MPL_Register_Table[i].Access == MPL_ACCESS_RW);
+        }
+    }
+
+    return false;
+}
+
+#endif
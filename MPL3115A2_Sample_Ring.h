@@ -0,0 +1,112 @@
+/*!
+ *   Lock-free single-producer / single-consumer ring of MPL3115A2 samples.
+ *
+ *   Intended to carry samples from interrupt context (e.g. the Done callback of MPL_Start_Sample())
+ *   to the main loop without disabling interrupts. Exactly one context may call Push() and exactly
+ *   one other context may call Pop(). Neither call blocks or takes a critical section.
+ *
+ *   Head is written by the producer only and Tail by the consumer only. Both are free-running
+ *   32-bit counters; the slot index is the counter masked with (Capacity - 1), which is why the
+ *   capacity must be a power of two.
+ *
+*/
+
+#ifndef MPL3115A2_SAMPLE_RING_H_
+#define MPL3115A2_SAMPLE_RING_H_
+
+#include "MPL3115A2_IO.h"
+
+#ifndef MPL_MEMORY_BARRIER
+#if defined(__CORTEX_M3) || defined(__CORTEX_M4) || defined(__CORTEX_M0) || defined(__CORTEX_M0PLUS) || defined(__CORTEX_M7)
+#define MPL_MEMORY_BARRIER() __DMB()                // Orders the slot copy against the index update. Also acts as a compiler barrier.
+#else
+#define MPL_MEMORY_BARRIER() __sync_synchronize()   // Host builds.
+#endif
+#endif
+
+template <unsigned Capacity, typename T = MPL_Sample>
+class MPL_Sample_Ring
+{
+
+public:
+
+    MPL_Sample_Ring() : Head(0), Tail(0), Overflows(0), Peak(0) {}
+
+    bool Push(const T &Sample)  // Producer side. Wait-free. Returns 'false' and counts an overflow when the ring is full; the new sample is dropped.
+    {
+        uint32_t Write_Index = Head;
+        uint32_t Used = Write_Index - Tail;
+
+        if (Used >= Capacity)
+        {
+            Overflows = Overflows + 1;  // Producer-owned counter, no read-modify-write race with the consumer.
+            return false;
+        }
+
+        Buffer[Write_Index & (Capacity - 1)] = Sample;
+
+        MPL_MEMORY_BARRIER();  // The sample must be in place before the consumer can see the new Head.
+
+        Head = Write_Index + 1;
+
+        if ((Used + 1) > Peak)
+        {
+            Peak = Used + 1;
+        }
+
+        return true;
+    }
+
+    unsigned Pop(T *Out, unsigned Max_Samples)  // Consumer side. Copies up to Max_Samples of the oldest samples into Out and returns how many were copied.
+    {
+        uint32_t Read_Index = Tail;
+        uint32_t Available = Head - Read_Index;
+
+        MPL_MEMORY_BARRIER();  // Do not read the slots before Head has been observed.
+
+        if (Available > Max_Samples)
+        {
+            Available = Max_Samples;
+        }
+
+        for (uint32_t i = 0; i < Available; i++)
+        {
+            Out[i] = Buffer[(Read_Index + i) & (Capacity - 1)];
+        }
+
+        MPL_MEMORY_BARRIER();  // The slots must be copied out before the producer may overwrite them.
+
+        Tail = Read_Index + Available;
+
+        return Available;
+    }
+
+    unsigned Count() const  // Samples currently stored. Exact from the consumer side, a lower bound from the producer side.
+    {
+        return Head - Tail;
+    }
+
+    uint32_t Overflow_Count() const  // Samples dropped because the ring was full.
+    {
+        return Overflows;
+    }
+
+    uint32_t Peak_Count() const  // Highest fill level seen by the producer.
+    {
+        return Peak;
+    }
+
+private:
+
+    typedef char Capacity_Must_Be_A_Power_Of_Two[((Capacity != 0) && ((Capacity & (Capacity - 1)) == 0)) ? 1 : -1];
+
+    T Buffer[Capacity];
+
+    volatile uint32_t Head;       // Next slot to write. Producer only.
+    volatile uint32_t Tail;       // Next slot to read. Consumer only.
+    volatile uint32_t Overflows;  // Producer only.
+    volatile uint32_t Peak;       // Producer only.
+
+};
+
+#endif
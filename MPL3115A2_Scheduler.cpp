@@ -0,0 +1,122 @@
+#include "MPL3115A2_Scheduler.h"
+
+
+MPL3115A2_Scheduler::MPL3115A2_Scheduler(MPL3115A2 *Sensor) : Sensor(Sensor)
+{
+    Request_Count = 0;
+    Switch_Count = 0;
+}
+
+bool MPL3115A2_Scheduler::Request(char Quantity, int32_t *Result)  // Queue a read. *Result is written by Run(). Returns 'false' when the queue is full.
+{
+    if ((Result == NULL) || (Quantity > MPL_REQUEST_TEMPERATURE) || (Request_Count >= MPL_SCHEDULER_MAX_REQUESTS))
+    {
+        return false;
+    }
+    
+    this->Quantity[Request_Count] = Quantity;
+    this->Result[Request_Count] = Result;
+    Served[Request_Count] = false;
+    Request_Count++;
+    
+    return true;
+}
+
+int MPL3115A2_Scheduler::Pending()  // Number of queued reads.
+{
+    return Request_Count;
+}
+
+int MPL3115A2_Scheduler::Run()  // Serve every queued read, batch of the current mode first.
+{
+    bool Need_Pressure = false;
+    bool Need_Altitude = false;
+    if (Request_Count == 0)
+    {
+        return 0;
+    }
+    
+    for (int i = 0; i < Request_Count; i++)
+    {
+        if (Quantity[i] == MPL_REQUEST_PRESSURE){Need_Pressure = true;}
+        if (Quantity[i] == MPL_REQUEST_ALTITUDE){Need_Altitude = true;}
+    }
+    
+    bool Current_Mode = Sensor->MPL_is_Barometer_Mode();
+    bool Need_Current = Current_Mode ? Need_Pressure : Need_Altitude;
+    bool Need_Other = Current_Mode ? Need_Altitude : Need_Pressure;
+    
+    if ((Need_Current == true) || (Need_Other == false))  // Temperature-only queues are served without touching the mode.
+    {
+        Serve_Batch(Current_Mode);
+    }
+    
+    if (Need_Other == true)
+    {
+        if (Current_Mode == true)   // The single mode write of this run. Done before the trigger of the batch.
+        {
+            Sensor->MPL_Altimeter_Mode();
+        }
+        
+        else
+        {
+            Sensor->MPL_Barometer_Mode();
+        }
+        
+        Switch_Count++;
+        
+        Serve_Batch(!Current_Mode);
+    }
+    
+    int Served_Count = 0;
+    
+    for (int i = 0; i < Request_Count; i++)
+    {
+        if (Served[i] == true){Served_Count++;}
+    }
+    
+    Request_Count = 0;
+    
+    return Served_Count;
+}
+
+uint32_t MPL3115A2_Scheduler::Mode_Switches()  // Mode writes done by Run() since the scheduler was created.
+{
+    return Switch_Count;
+}
+
+void MPL3115A2_Scheduler::Serve_Batch(bool Bar_Mode)  // One acquisition in the given mode, then every matching request is filled from it.
+{
+    MPL_Sample Sample;
+    
+    if (Sensor->MPL_Read_Sample(Sample) == false)  // One OST, one wait, one 5-byte burst. The mode was set before the trigger, so Sample.Bar_Mode == Bar_Mode.
+    {
+        return;   // Conversion timed out: the requests of this batch stay unserved, their results untouched.
+    }
+    
+    for (int i = 0; i < Request_Count; i++)
+    {
+        if (Served[i] == true)   // Temperature is taken from the first batch of the run.
+        {
+            continue;
+        }
+        
+        if ((Quantity[i] == MPL_REQUEST_PRESSURE) && (Bar_Mode == true))
+        {
+            *Result[i] = Sample.Pressure_Fixed;
+            Served[i] = true;
+        }
+        
+        else if ((Quantity[i] == MPL_REQUEST_ALTITUDE) && (Bar_Mode == false))
+        {
+            *Result[i] = Sample.Altitude_Fixed;
+            Served[i] = true;
+        }
+        
+        else if (Quantity[i] == MPL_REQUEST_TEMPERATURE)
+        {
+            *Result[i] = Sample.Temperature_Fixed;
+            Served[i] = true;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include "mbed.h"
+#ifndef MPL3115A2_SCHEDULER_H_
+#define MPL3115A2_SCHEDULER_H_
+
+#include "MPL3115A2_IO.h"
+
+#define MPL_SCHEDULER_MAX_REQUESTS 16   // Pending reads per scheduler.
+
+#define MPL_REQUEST_PRESSURE    0   // Q18.2 Pa. Needs a Barometer mode conversion.
+#define MPL_REQUEST_ALTITUDE    1   // Q16.4 m. Needs an Altimeter mode conversion.
+#define MPL_REQUEST_TEMPERATURE 2   // Q8.4 C. Valid in either mode, joins the first batch.
+
+class MPL3115A2_Scheduler   // Queues Pressure/Altitude/Temperature reads and serves them in per-mode batches: one mode switch and one OST per batch, never a value converted in the wrong mode.
+{
+
+public:
+
+    MPL3115A2_Scheduler(MPL3115A2 *Sensor);
+
+    bool Request(char Quantity, int32_t *Result);  // Queue a read. Quantity: MPL_REQUEST_PRESSURE, _ALTITUDE or _TEMPERATURE. *Result is written by Run(). Returns 'false' when the queue is full.
+
+    int Pending();  // Number of queued reads.
+
+    int Run();  // Serve every queued read. The batch of the current mode goes first, so at most one CTRL_REG1 mode write is done. Returns the number of reads served: reads of a batch whose conversion timed out are not, and their *Result is left untouched.
+
+    uint32_t Mode_Switches();  // Mode writes done by Run() since the scheduler was created.
+
+private:
+
+    void Serve_Batch(bool Bar_Mode);  // One acquisition in the given mode, then every matching request is filled from it.
+
+    MPL3115A2 *Sensor;
+
+    char Quantity[MPL_SCHEDULER_MAX_REQUESTS];
+    int32_t *Result[MPL_SCHEDULER_MAX_REQUESTS];
+    bool Served[MPL_SCHEDULER_MAX_REQUESTS];
+    int Request_Count;
+
+    uint32_t Switch_Count;
+
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*!
+ *   Core sleep while the MPL3115A2 converts, shared by MPL3115A2 (MPL3115A2_IO.h) and MPL3115A2T (MPL3115A2T.h).
+ *
+ *   MPL_Sleep_Timer::Sleep() puts the core to sleep until an interrupt raises a flag or a Timeout ends the
+ *   wait. The flag test and the sleep run with interrupts masked: an interrupt that lands between them stays
+ *   pending, WFI returns at once and the handler runs when the mask is lifted. Nothing is lost and nothing
+ *   waits for the timeout it did not need.
+ *
+*/
+
+#include "mbed.h"
+#ifndef MPL3115A2_SLEEP_H_
+#define MPL3115A2_SLEEP_H_
+
+#define MPL_CONVERSION_RETRY_US 1000  // Extra wait when OST is still set after the nominal conversion time.
+#define MPL_CONVERSION_TIMEOUT  2     // A conversion is given up after this many nominal conversion times.
+
+class MPL_Sleep_Timer
+{
+
+public:
+
+    MPL_Sleep_Timer() : Expired(false) {}
+
+    bool Sleep(volatile bool *Flag, uint32_t Timeout_us, bool Deep_Sleep = false)  // Until *Flag is raised or Timeout_us elapses. Flag = NULL sleeps for Timeout_us, Timeout_us = 0 waits for the flag only. Returns 'true' if the flag was raised (always for Flag = NULL).
+    {
+        Expired = false;
+
+        if (Timeout_us != 0)
+        {
+            Wake_Timer.attach_us(this, &MPL_Sleep_Timer::Timeout_Handler, Timeout_us);
+        }
+
+        while (true)
+        {
+            __disable_irq();
+
+            if (((Flag != NULL) && (*Flag == true)) || (Expired == true))
+            {
+                __enable_irq();
+                break;
+            }
+
+            if (Deep_Sleep)
+            {
+                deepsleep();   // Peripheral clocks stop on the LPC1768: only a pin interrupt wakes the core, the Timeout does not.
+            }
+
+            else
+            {
+                sleep();
+            }
+
+            __enable_irq();    // The interrupt that woke the core is taken here. The loop re-checks both conditions.
+        }
+
+        Wake_Timer.detach();
+
+        return (Flag == NULL) || (*Flag == true);
+    }
+
+private:
+
+    void Timeout_Handler()
+    {
+        Expired = true;
+    }
+
+    Timeout Wake_Timer;
+    volatile bool Expired;
+
+};
+
+#endif
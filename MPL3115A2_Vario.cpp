@@ -0,0 +1,137 @@
+#include "MPL3115A2_Vario.h"
+
+
+MPL3115A2_Vario::MPL3115A2_Vario(int Window)
+{
+    if (Window < 2){Window = 2;}
+    if (Window > MPL_VARIO_MAX_WINDOW){Window = MPL_VARIO_MAX_WINDOW;}
+    
+    this->Window = Window;
+    
+    Reset();
+}
+
+void MPL3115A2_Vario::Reset()  // Empty the window.
+{
+    Head = 0;
+    Count = 0;
+    Speed_Q12 = 0;
+}
+
+void MPL3115A2_Vario::Update(const MPL_Sample &Sample)  // Add the altitude of the sample at its timestamp to the window.
+{
+    Add(Sample.Timestamp_us, Sample.Altitude_Fixed);
+}
+
+void MPL3115A2_Vario::Update(const MPL_Frame &Frame, uint32_t Step_us)  // Same, from MPL_Read_Frame(). Restarts from the delta registers after missed conversions.
+{
+    uint32_t Now_us = Frame.Current.Timestamp_us;
+    int Newest = (Head + MPL_VARIO_MAX_WINDOW - 1) % MPL_VARIO_MAX_WINDOW;
+    
+    // The delta registers hold the change since the previous conversion. If the previous conversion is not the last
+    // point of the window, conversions were missed and a line across the gap would average a climb that may already
+    // have changed: start again from the two points the delta gives, one step apart.
+    if ((Count > 0) && (Step_us != 0) && ((Frame.Current.Altitude_Fixed - Frame.Altitude_Change_Fixed) != Altitude[Newest]))
+    {
+        Reset();
+        Add(Now_us - Step_us, Frame.Current.Altitude_Fixed - Frame.Altitude_Change_Fixed);
+    }
+    
+    Add(Now_us, Frame.Current.Altitude_Fixed);
+}
+
+void MPL3115A2_Vario::Add(uint32_t Time_us, int32_t Altitude)  // Append one point and refit. O(Window), no division in the loop.
+{
+    this->Time_us[Head] = Time_us;
+    this->Altitude[Head] = Altitude;
+    Head = (Head + 1) % MPL_VARIO_MAX_WINDOW;
+    
+    if (Count < Window){Count++;}
+    
+    if (Count < 2)
+    {
+        Speed_Q12 = 0;
+        return;
+    }
+    
+    // Least squares slope: (n Sum(t h) - Sum(t) Sum(h)) / (n Sum(t^2) - Sum(t)^2). Times and altitudes are taken relative
+    // to the newest point. Times are counted in 2^Shift us units, Shift chosen so that the span of the window fits 16 bits
+    // whatever the OSR or a stalled reader did to it: with altitudes inside the 20-bit range of the sensor (deltas of
+    // at most 2^21) the sums stay below 2^46 and every product below 2^61.
+    int Newest = (Head + MPL_VARIO_MAX_WINDOW - 1) % MPL_VARIO_MAX_WINDOW;
+    uint32_t Span_us = 0;
+    
+    for (int i = 1; i < Count; i++)
+    {
+        int Index = (Newest + MPL_VARIO_MAX_WINDOW - i) % MPL_VARIO_MAX_WINDOW;
+        uint32_t Age_us = this->Time_us[Newest] - this->Time_us[Index];   // Wraps correctly on the 32-bit ticker.
+        
+        if (Age_us > Span_us){Span_us = Age_us;}
+    }
+    
+    int Shift = 0;
+    
+    while ((Span_us >> Shift) > 0xFFFF){Shift++;}
+    
+    int64_t Sum_T = 0, Sum_H = 0, Sum_TT = 0, Sum_TH = 0;
+    
+    for (int i = 0; i < Count; i++)
+    {
+        int Index = (Newest + MPL_VARIO_MAX_WINDOW - i) % MPL_VARIO_MAX_WINDOW;
+        int64_t T = -(int64_t)((uint32_t)(this->Time_us[Newest] - this->Time_us[Index]) >> Shift);
+        int64_t H = this->Altitude[Index] - this->Altitude[Newest];
+        
+        Sum_T += T;
+        Sum_H += H;
+        Sum_TT += T * T;
+        Sum_TH += T * H;
+    }
+    
+    int64_t Sxx = Count * Sum_TT - Sum_T * Sum_T;
+    int64_t Sxy = Count * Sum_TH - Sum_T * Sum_H;
+    
+    if (Sxx <= 0)   // All points at the same time
+    {
+        return;
+    }
+    
+    // Slope in Q16.4 per 2^Shift us. Q.12 per second is Sxy * 15625 * 2^14 / (Sxx * 2^Shift): the 15625 goes in first,
+    // the power of two either widens the divisor or is applied to the quotient, whole part then fraction, to stay inside 64 bits.
+    bool Negative = (Sxy < 0);
+    int64_t Scaled = (Negative ? -Sxy : Sxy) * 15625;
+    int Up = (Shift < 14) ? (14 - Shift) : 0;
+    int64_t Divisor = Sxx << ((Shift > 14) ? (Shift - 14) : 0);
+    int64_t Whole = Scaled / Divisor;
+    int64_t Fraction = ((Scaled % Divisor) << Up) / Divisor;
+    int64_t Speed = (Whole << Up) + Fraction;
+    
+    Speed_Q12 = (int32_t)(Negative ? -Speed : Speed);
+}
+
+bool MPL3115A2_Vario::Ready()  // 'true' once two samples are in the window.
+{
+    return (Count >= 2);
+}
+
+int32_t MPL3115A2_Vario::Vertical_Speed_Fixed()  // Q16.4 m/s
+{
+    return (Speed_Q12 + 128) >> 8;
+}
+
+double MPL3115A2_Vario::Vertical_Speed()  // Meters per second
+{
+    return (double)Speed_Q12 / 4096.0;
+}
+
+uint32_t MPL3115A2_Vario::Window_us()  // Time covered by the window.
+{
+    if (Count < 2)
+    {
+        return 0;
+    }
+    
+    int Newest = (Head + MPL_VARIO_MAX_WINDOW - 1) % MPL_VARIO_MAX_WINDOW;
+    int Oldest = (Head + MPL_VARIO_MAX_WINDOW - Count) % MPL_VARIO_MAX_WINDOW;
+    
+    return Time_us[Newest] - Time_us[Oldest];
+}
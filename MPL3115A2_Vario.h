@@ -0,0 +1,45 @@
+#include "mbed.h"
+#ifndef MPL3115A2_VARIO_H_
+#define MPL3115A2_VARIO_H_
+
+#include "MPL3115A2_IO.h"
+
+#define MPL_VARIO_MAX_WINDOW 16   // Samples in the regression window, upper bound.
+#define MPL_VARIO_WINDOW     8    // Default window. Latency is about half the window: 8 samples at OS1 is about 25 ms.
+
+class MPL3115A2_Vario   // Vertical speed from a least-squares line through the last samples, published on every sample. Works on samples already read: no bus traffic of its own.
+{
+
+public:
+
+    MPL3115A2_Vario(int Window = MPL_VARIO_WINDOW);  // 2 .. MPL_VARIO_MAX_WINDOW samples.
+
+    void Reset();  // Empty the window.
+
+    void Update(const MPL_Sample &Sample);  // Add the altitude of the sample at Sample.Timestamp_us to the window. Both modes.
+
+    void Update(const MPL_Frame &Frame, uint32_t Step_us);  // Same, from MPL_Read_Frame(). When conversions were missed since the previous update, the window restarts from the delta registers: the slope of the last step rather than one across the gap.
+
+    bool Ready();  // 'true' once two samples are in the window.
+
+    int32_t Vertical_Speed_Fixed();  // Q16.4 m/s. Positive when climbing.
+
+    double Vertical_Speed();  // Meters per second, from the Q.12 result.
+
+    uint32_t Window_us();  // Time covered by the window.
+
+private:
+
+    void Add(uint32_t Time_us, int32_t Altitude);  // Append one point and refit.
+
+    int Window;
+    uint32_t Time_us[MPL_VARIO_MAX_WINDOW];
+    int32_t Altitude[MPL_VARIO_MAX_WINDOW];   // Q16.4 m
+    int Head;    // Next slot
+    int Count;
+
+    int32_t Speed_Q12;   // 1/4096 m/s
+
+};
+
+#endif
@@ -0,0 +1,650 @@
+/*!
+ *   Host benchmark of the MPL3115A2 driver against the simulated device.
+ *
+ *   Every public API call is run on a fresh virtual clock and reported with the number of I2C
+ *   transactions, bytes on the wire, simulated bus time and simulated wall time. The output is
+ *   deterministic, so it can be diffed before and after a driver change. The process exits non-zero when a
+ *   correctness check fails: batch decoder bit-identity, sample ring order and drops, log read-back, async completion.
+ *
+ *   Build and run from the repository root (-funsigned-char matches the ARM ABI of the target):
+ *
+ *      g++ -std=gnu++98 -funsigned-char -Ihost -I. host/mbed_sim.cpp host/MPL3115A2_Sim.cpp host/MPL3115A2_Bench.cpp \
+ *          MPL3115A2_IO.cpp MPL3115A2_Altitude.cpp MPL3115A2_Group.cpp MPL3115A2_Scheduler.cpp \
+ *          MPL3115A2_Decode_Batch.cpp MPL3115A2_Adaptive.cpp MPL3115A2_Kalman.cpp \
+ *          MPL3115A2_Vario.cpp MPL3115A2_Log.cpp host/MPL3115A2_Log_Reader.cpp -o mpl_bench
+ *      ./mpl_bench
+ *
+ *   Add -DMPL3115A2_BUS_STATS to also print the driver's own per-register counters and latency histogram.
+ *
+*/
+
+#include "mbed.h"
+#include <math.h>
+#include "MPL3115A2_IO.h"
+#include "MPL3115A2_Group.h"
+#include "MPL3115A2_Scheduler.h"
+#include "MPL3115A2_Adaptive.h"
+#include "MPL3115A2_Kalman.h"
+#include "MPL3115A2_Vario.h"
+#include "MPL3115A2_Log.h"
+#include "MPL3115A2_Log_Reader.h"
+#include "MPL3115A2_Sample_Ring.h"
+#include "MPL3115A2T.h"
+#include "MPL3115A2_Decode_Batch.h"
+#include "MPL3115A2_Sim.h"
+
+static uint64_t Start_us;
+
+static void Begin()
+{
+    Sim_Bus_Reset();
+    Start_us = Sim_Now_us();
+}
+
+static void End_Columns(const char *Name)  // The columns of End() without the line break: the caller appends its own.
+{
+    printf("%-44s %6lu %7lu %10llu %10llu", Name,
+           (unsigned long)Sim_Bus.Transactions, (unsigned long)Sim_Bus.Bytes,
+           (unsigned long long)Sim_Bus.Bus_Time_us, (unsigned long long)(Sim_Now_us() - Start_us));
+}
+
+static void End(const char *Name)
+{
+    End_Columns(Name);
+    printf("\n");
+}
+
+#define BENCH(Name, Statement) do { Begin(); Statement; End(Name); } while (0)
+
+static int Failures;   // Broken invariants: the exit status of the bench.
+
+static void Check(bool Holds, const char *What)  // Correctness, not timing: a regression fails the run instead of only changing the table.
+{
+    if (Holds == false)
+    {
+        printf("CHECK FAILED: %s\n", What);
+        Failures++;
+    }
+}
+
+static volatile bool Async_Finished;
+static bool Async_Success;
+
+static void Async_Done(bool Success)  // Completion callback of MPL_Start_Sample(), from the transfer or pin interrupt.
+{
+    Async_Success = Success;
+    Async_Finished = true;
+}
+
+static bool Async_Read_Sample(MPL3115A2 &MPL, MPL_Sample &Sample)  // Start the chain, then sleep until it reports.
+{
+    Async_Finished = false;
+
+    if (MPL.MPL_Start_Sample(Sample, Async_Done) == false)
+    {
+        return false;
+    }
+
+    while (Async_Finished == false)
+    {
+        __WFI();
+    }
+
+    return Async_Success;
+}
+
+static MPL_Sample_Ring<8> Ring;
+static MPL3115A2 *Ring_Sensor;
+static MPL_Sample Ring_Slot;          // Filled by the chain, copied into the ring by Ring_Done()
+static uint32_t Ring_Produced_us[16];  // Timestamps in production order
+static int Ring_Produced;
+static int Ring_Remaining;
+
+static void Ring_Done(bool Success)  // Producer: interrupt context. Push the sample and start the next one.
+{
+    if (Success)
+    {
+        Ring.Push(Ring_Slot);
+        Ring_Produced_us[Ring_Produced++ % 16] = Ring_Slot.Timestamp_us;
+    }
+
+    if (--Ring_Remaining > 0)
+    {
+        Ring_Sensor->MPL_Start_Sample(Ring_Slot, Ring_Done);
+    }
+}
+
+static int Ring_Check(int Count, bool Stall, int &Popped)  // Produce Count samples; the consumer pops as they come, or only once all are produced. Returns the samples out of order.
+{
+    MPL_Sample Out[8];
+    int Out_Of_Order = 0;
+
+    Ring_Produced = 0;
+    Popped = 0;
+    Ring_Remaining = Count;
+    Ring_Sensor->MPL_Start_Sample(Ring_Slot, Ring_Done);
+
+    while ((Ring_Remaining > 0) || (Ring.Count() != 0))
+    {
+        __WFI();
+
+        if (Stall && (Ring_Remaining > 0))
+        {
+            continue;
+        }
+
+        unsigned Got = Ring.Pop(Out, 8);
+
+        for (unsigned i = 0; i < Got; i++, Popped++)
+        {
+            Out_Of_Order += (Out[i].Timestamp_us != Ring_Produced_us[Popped % 16]);   // The oldest samples survive an overflow.
+        }
+    }
+
+    return Out_Of_Order;
+}
+
+int main()
+{
+    MPL3115A2_Sim Sim(p9);
+    Sim.Connect_INT1(p8);
+    Sim.Set_Environment(101325.0, 21.5);
+
+    MPL3115A2 MPL(p9, p10, p8);
+
+    MPL_Sample Sample;
+    MPL_Extremes Extremes;
+    MPL_Frame Frame;
+    MPL_Sample FIFO_Samples[F_DEPTH];
+    volatile double Value;
+    volatile char Byte;
+
+    printf("%-44s %6s %7s %10s %10s\n", "API call", "xfers", "bytes", "bus_us", "elapsed_us");
+
+    BENCH("MPL_System_Reset", MPL.MPL_System_Reset());
+    BENCH("MPL_Who_Am_I_", Byte = MPL.MPL_Who_Am_I_());
+    BENCH("MPL_Get_Status", Byte = MPL.MPL_Get_Status());
+    BENCH("MPL_is_Active", Byte = MPL.MPL_is_Active());
+
+    BENCH("MPL_Set_Oversampling(1)", MPL.MPL_Set_Oversampling(1));
+    BENCH("MPL_Get_Pressure OS1", Value = MPL.MPL_Get_Pressure());
+    BENCH("MPL_Get_Temperature OS1", Value = MPL.MPL_Get_Temperature());
+    BENCH("MPL_Read_Sample OS1", MPL.MPL_Read_Sample(Sample));
+    BENCH("MPL_Get_Altitude OS1 (mode switch)", Value = MPL.MPL_Get_Altitude());
+    BENCH("MPL_Get_Pressure OS1 (mode switch)", Value = MPL.MPL_Get_Pressure());
+    BENCH("MPL_Set_Software_Altitude(true)", MPL.MPL_Set_Software_Altitude(true));
+    BENCH("MPL_Get_Altitude OS1 (software)", Value = MPL.MPL_Get_Altitude());
+    BENCH("MPL_Get_Pressure OS1 (no switch)", Value = MPL.MPL_Get_Pressure());
+    BENCH("MPL_Set_Software_Altitude(false)", MPL.MPL_Set_Software_Altitude(false));
+
+    // Mixed reads: one getter each vs. the mode-batching scheduler.
+    MPL3115A2_Scheduler Scheduler(&MPL);
+    int32_t Results[6];
+
+    BENCH("P, A, T, P, A, T getters OS1", Value = MPL.MPL_Get_Pressure(); Value = MPL.MPL_Get_Altitude(); Value = MPL.MPL_Get_Temperature();
+                                          Value = MPL.MPL_Get_Pressure(); Value = MPL.MPL_Get_Altitude(); Value = MPL.MPL_Get_Temperature());
+    BENCH("P, A, T, P, A, T scheduler OS1", for (int i = 0; i < 6; i++) { Scheduler.Request((char)(i % 3), &Results[i]); } Scheduler.Run());
+    MPL.MPL_Barometer_Mode();
+
+    BENCH("MPL_Set_Oversampling(128)", MPL.MPL_Set_Oversampling(128));
+    BENCH("MPL_Get_Pressure OS128", Value = MPL.MPL_Get_Pressure());
+    BENCH("MPL_Get_Temperature OS128", Value = MPL.MPL_Get_Temperature());
+    BENCH("MPL_Read_Sample OS128", MPL.MPL_Read_Sample(Sample));
+
+    BENCH("MPL_Get_Pressure_Change", Value = MPL.MPL_Get_Pressure_Change());
+    BENCH("MPL_Get_Temperature_Change", Value = MPL.MPL_Get_Temperature_Change());
+    BENCH("MPL_Get_Min_Pressure", Value = MPL.MPL_Get_Min_Pressure());
+    BENCH("MPL_Get_Max_Pressure", Value = MPL.MPL_Get_Max_Pressure());
+    BENCH("MPL_Get_Min_Temperature", Value = MPL.MPL_Get_Min_Temperature());
+    BENCH("MPL_Get_Max_Temperature", Value = MPL.MPL_Get_Max_Temperature());
+    BENCH("6 x MPL_Get_Min/Max_...", Value = MPL.MPL_Get_Min_Pressure(); Value = MPL.MPL_Get_Max_Pressure(); Value = MPL.MPL_Get_Min_Temperature();
+                                     Value = MPL.MPL_Get_Max_Temperature(); Value = MPL.MPL_Get_Min_Altitude(); Value = MPL.MPL_Get_Max_Altitude());
+    MPL.MPL_Barometer_Mode();
+    BENCH("MPL_Get_Extremes", MPL.MPL_Get_Extremes(Extremes));
+    BENCH("MPL_Get_Extremes (reset)", MPL.MPL_Get_Extremes(Extremes, true));
+    BENCH("MPL_Reset_Min_P_A", MPL.MPL_Reset_Min_P_A());
+
+    BENCH("MPL_Set_Barometric_Reference", MPL.MPL_Set_Barometric_Reference(101325));
+    BENCH("MPL_Get_Barometric_Reference", Value = MPL.MPL_Get_Barometric_Reference());
+    BENCH("MPL_Set_Pressure_Target", MPL.MPL_Set_Pressure_Target(100000));
+    BENCH("MPL_Set_Pressure_Window", MPL.MPL_Set_Pressure_Window(1000));
+    BENCH("MPL_Set_Temperature_Target", MPL.MPL_Set_Temperature_Target(25));
+    BENCH("MPL_Set_Temperature_Window", MPL.MPL_Set_Temperature_Window(5));
+    BENCH("MPL_Trim_Pressure", MPL.MPL_Trim_Pressure(0));
+
+    BENCH("Reference + alarm setup (6 setters)", MPL.MPL_Set_Barometric_Reference(101325); MPL.MPL_Set_Pressure_Target(100000); MPL.MPL_Set_Temperature_Target(25);
+                                                  MPL.MPL_Set_Pressure_Window(1000); MPL.MPL_Set_Temperature_Window(5); MPL.MPL_Trim_Altitude(0));
+    BENCH("Reference + alarm setup (batched)", MPL.MPL_Begin_Batch(); MPL.MPL_Set_Barometric_Reference(101325); MPL.MPL_Set_Pressure_Target(100000);
+                                                MPL.MPL_Set_Temperature_Target(25); MPL.MPL_Set_Pressure_Window(1000); MPL.MPL_Set_Temperature_Window(5);
+                                                MPL.MPL_Trim_Altitude(0); MPL.MPL_Flush());
+    BENCH("MPL_Stage<BAR_IN, P_TGT, T_TGT> + MPL_Flush", MPL.MPL_Stage<MPL_Reg_BAR_IN>(101326 / 2); MPL.MPL_Stage<MPL_Reg_P_TGT>(50000);
+                                                         MPL.MPL_Stage<MPL_Reg_T_TGT>(25); MPL.MPL_Flush());
+
+    BENCH("MPL_Set_Oversampling(1)", MPL.MPL_Set_Oversampling(1));
+    BENCH("MPL_Enable_Data_Ready_Interrupt(INT1)", MPL.MPL_Enable_Data_Ready_Interrupt(true));
+    BENCH("MPL_Read_Sample OS1 (interrupt)", MPL.MPL_Read_Sample(Sample));
+    BENCH("MPL_Set_Oversampling(128)", MPL.MPL_Set_Oversampling(128));
+    BENCH("MPL_Read_Sample OS128 (interrupt)", MPL.MPL_Read_Sample(Sample));
+    BENCH("MPL_Disable_Data_Ready_Interrupt", MPL.MPL_Disable_Data_Ready_Interrupt());
+
+    BENCH("MPL_Set_Oversampling(1)", MPL.MPL_Set_Oversampling(1));
+    BENCH("MPL_Set_FIFO_Mode(circular)", MPL.MPL_Set_FIFO_Mode(F_SETUP_F_MODE_CIRCULAR, 0));
+    BENCH("MPL_Start_Continuous(1)", MPL.MPL_Start_Continuous(1));
+    BENCH("wait 32 s", wait(32.0f));
+    BENCH("MPL_Drain_FIFO(32)", Byte = MPL.MPL_Drain_FIFO(FIFO_Samples, F_DEPTH));
+    BENCH("MPL_Set_FIFO_Mode(disabled)", MPL.MPL_Set_FIFO_Mode(F_SETUP_F_MODE_DISABLED, 0));
+    BENCH("MPL_Read_Latest_Sample", MPL.MPL_Read_Latest_Sample(Sample));
+    BENCH("MPL_Read_Latest_Sample + 2 x Get_..._Change", MPL.MPL_Read_Latest_Sample(Sample); Value = MPL.MPL_Get_Pressure_Change(); Value = MPL.MPL_Get_Temperature_Change());
+    BENCH("MPL_Read_Frame", Byte = MPL.MPL_Read_Frame(Frame));
+    BENCH("MPL_Stop_Continuous", MPL.MPL_Stop_Continuous());
+
+    (void)Value;   // The sinks only keep the calls above from being optimized out.
+    (void)Byte;
+
+    // Four sensors on four buses: sequential vs. pipelined.
+    MPL3115A2_Sim Sim_B(p28);
+    MPL3115A2_Sim Sim_C(p5);
+    MPL3115A2_Sim Sim_D(p13);
+    MPL3115A2 MPL_B(p28, p27);
+    MPL3115A2 MPL_C(p5, p6);
+    MPL3115A2 MPL_D(p13, p14);
+    MPL3115A2 *All[4] = {&MPL, &MPL_B, &MPL_C, &MPL_D};
+    MPL_Sample Group_Samples[4];
+    MPL3115A2_Group Group;
+
+    for (int i = 0; i < 4; i++)
+    {
+        All[i]->MPL_Set_Oversampling(16);
+        Group.Add(All[i]);
+    }
+
+    BENCH("4 x MPL_Read_Sample OS16 (sequential)", for (int i = 0; i < 4; i++) { All[i]->MPL_Read_Sample(Group_Samples[i]); });
+    BENCH("MPL3115A2_Group::Sample_All OS16 (4 buses)", Group.Sample_All(Group_Samples));
+
+    // Same acquisition through the runtime class and the compile-time specialized template.
+    MPL3115A2_Sim Sim_T(p17);
+    MPL3115A2T<MPL_MODE_BAROMETER, 16> MPL_T(p17, p18);
+    int32_t Value_Fixed, Temperature_Fixed;
+
+    BENCH("MPL3115A2T::MPL_Init", MPL_T.MPL_Init());
+    BENCH("MPL3115A2T::MPL_Read OS16", Value_Fixed = MPL_T.MPL_Read());
+    BENCH("MPL3115A2T::MPL_Read_Sample OS16", MPL_T.MPL_Read_Sample(Value_Fixed, Temperature_Fixed));
+    BENCH("MPL_Read_Sample OS16", MPL.MPL_Read_Sample(Sample));
+
+    // Adaptive OSR: 1 Pa noise target with 6 Pa of sensor noise at OS1, 300 ms latency budget. 64 samples at rest,
+    // 64 samples climbing at 5 m/s, 64 samples at rest again. Fixed OS64 for comparison.
+    static const char *Phases[3] = {"rest", "climb 5 m/s", "rest"};
+    static const double Climb[3] = {0.0, 5.0, 0.0};
+
+    MPL.MPL_Barometer_Mode();
+    MPL.MPL_Set_Oversampling(1);
+    Sim.Set_Noise(6.0);
+
+    MPL3115A2_Adaptive_OSR Adaptive(&MPL, 4, 300000);   // 4 x 0.25 Pa
+
+    printf("\n%-44s %6s %7s %10s %10s %4s %6s %6s %8s\n", "MPL3115A2_Adaptive_OSR", "xfers", "bytes", "bus_us", "elapsed_us", "OSR", "noise", "rate", "switches");
+
+    for (int Phase = 0; Phase < 3; Phase++)
+    {
+        Sim.Set_Climb_Rate(Climb[Phase]);
+        Begin();
+
+        for (int i = 0; i < 64; i++)
+        {
+            MPL.MPL_Read_Sample(Sample);
+            Adaptive.Update(Sample);
+        }
+
+        End_Columns(Phases[Phase]);
+        printf(" %4d %6ld %6ld %8lu\n", (int)Adaptive.Oversampling(), (long)Adaptive.Noise(), (long)Adaptive.Rate(), (unsigned long)Adaptive.Switches());
+    }
+
+    MPL.MPL_Set_Oversampling(64);
+
+    for (int Phase = 0; Phase < 3; Phase++)
+    {
+        Sim.Set_Climb_Rate(Climb[Phase]);
+        Begin();
+
+        for (int i = 0; i < 64; i++)
+        {
+            MPL.MPL_Read_Sample(Sample);
+        }
+
+        End_Columns((Phase == 1) ? "fixed OS64, climb 5 m/s" : "fixed OS64, rest");
+        printf(" %4d %6s %6s %8s\n", 64, "-", "-", "-");
+    }
+
+    Sim.Set_Climb_Rate(0.0);
+    Sim.Set_Noise(0.0);
+
+    // Kalman filter: OS8 at 16 times the sample rate of OS128, same 6 Pa sensor noise. Spread of the altitude over
+    // the last 4 s of 8 s at rest (the filter has settled) and vertical speed at the end of 8 s climbing at 5 m/s.
+    static const int Kalman_OSR[2] = {128, 8};
+
+    Sim.Set_Noise(6.0);
+    printf("\n%-44s %6s %9s %9s %9s\n", "MPL3115A2_Kalman", "OSR", "samples", "sd_mm", "v_mm/s");
+
+    for (int Filtered = 0; Filtered < 2; Filtered++)
+    {
+        int OSR = Kalman_OSR[Filtered];
+        MPL3115A2_Kalman Kalman((int32_t)(6.0 / sqrt((double)OSR) / 12.0 * 16.0 + 0.5), 8);   // Sensor noise in Q16.4 m (about 12 Pa/m), 0.5 m/s^2
+        double Sum = 0, Sum_2 = 0;
+        int Count = 0;
+
+        MPL.MPL_Set_Oversampling(OSR);
+        Sim.Set_Climb_Rate(0.0);
+
+        for (uint64_t Start = Sim_Now_us(); (Sim_Now_us() - Start) < 8000000; )
+        {
+            MPL.MPL_Read_Sample(Sample);
+            Kalman.Update(Sample);
+
+            if ((Sim_Now_us() - Start) < 4000000)
+            {
+                continue;
+            }
+
+            double Altitude = (Filtered == 1) ? (Kalman.Altitude() / 16.0) : Sample.Altitude;
+            Sum += Altitude;
+            Sum_2 += Altitude * Altitude;
+            Count++;
+        }
+
+        Sim.Set_Climb_Rate(5.0);
+
+        for (uint64_t Start = Sim_Now_us(); (Sim_Now_us() - Start) < 8000000; )
+        {
+            MPL.MPL_Read_Sample(Sample);
+            Kalman.Update(Sample);
+        }
+
+        printf("%-44s %6d %9d %9.1f %9.0f\n", (Filtered == 1) ? "OS8 + Kalman" : "OS128 raw (Kalman speed)", OSR, Count,
+               1000.0 * sqrt(Sum_2 / Count - (Sum / Count) * (Sum / Count)), 1000.0 * Kalman.Vertical_Speed() / 16.0);
+    }
+
+    Sim.Set_Climb_Rate(0.0);
+    Sim.Set_Noise(0.0);
+
+    // Variometer at OS4 in Altimeter mode, 0.5 Pa of sensor noise: spread of the vertical speed over 0.5 s at rest, then
+    // time from the start of a 2 m/s climb until the output reaches 1 m/s. Two-sample difference for comparison.
+    MPL3115A2_Vario Vario;
+    double Speed_Sum[2] = {0, 0}, Speed_Sum_2[2] = {0, 0}, Previous_Altitude = 0;
+    uint32_t Half_Speed_us[2] = {0, 0};
+    int Speed_Count = 0;
+    bool Previous_Altitude_Valid = false;
+
+    MPL.MPL_Altimeter_Mode();
+    MPL.MPL_Set_Oversampling(4);
+    Sim.Set_Noise(0.5);
+    Begin();
+
+    for (uint64_t Start = Sim_Now_us(), Climb_us = 0, Previous_us = 0; (Sim_Now_us() - Start) < 1000000; )
+    {
+        MPL.MPL_Read_Sample(Sample);
+        Vario.Update(Sample);
+
+        double Speed[2] = {Vario.Vertical_Speed(), (Previous_us == 0) ? 0.0 : (Sample.Altitude - Previous_Altitude) * 1000000.0 / (double)(Sim_Now_us() - Previous_us)};
+        Previous_Altitude = Sample.Altitude;
+        Previous_us = Sim_Now_us();
+
+        if (Climb_us == 0)
+        {
+            for (int i = 0; (i < 2) && (Previous_Altitude_Valid == true); i++)   // The first difference has nothing to start from.
+            {
+                Speed_Sum[i] += Speed[i];
+                Speed_Sum_2[i] += Speed[i] * Speed[i];
+            }
+
+            Speed_Count += (Previous_Altitude_Valid == true) ? 1 : 0;
+            Previous_Altitude_Valid = true;
+
+            if ((Sim_Now_us() - Start) >= 500000)
+            {
+                Sim.Set_Climb_Rate(2.0);
+                Climb_us = Sim_Now_us();
+            }
+        }
+
+        else
+        {
+            for (int i = 0; i < 2; i++)
+            {
+                if ((Half_Speed_us[i] == 0) && (Speed[i] >= 1.0)){Half_Speed_us[i] = (uint32_t)(Sim_Now_us() - Climb_us);}
+            }
+        }
+    }
+
+    End("MPL3115A2_Vario OS4, 1 s");
+
+    for (int i = 0; i < 2; i++)
+    {
+        double Mean = Speed_Sum[i] / Speed_Count;
+        printf("%-44s sd %.3f m/s, 1 m/s after %lu us\n", (i == 0) ? "  regression, 8 samples" : "  difference of two samples",
+               sqrt(Speed_Sum_2[i] / Speed_Count - Mean * Mean), (unsigned long)Half_Speed_us[i]);
+    }
+
+    MPL.MPL_Barometer_Mode();
+    Sim.Set_Climb_Rate(0.0);
+    Sim.Set_Noise(0.0);
+
+    // FIFO in STOP mode left to overflow: per-sample times rebuilt from TIME_DLY against the true conversion times.
+    MPL.MPL_Set_Oversampling(1);
+    MPL.MPL_Set_FIFO_Mode(F_SETUP_F_MODE_STOP, 0);
+
+    uint32_t Activation_us = us_ticker_read();
+    MPL.MPL_Start_Continuous(1);
+    wait(40.0f);
+
+    int Drained = MPL.MPL_Drain_FIFO(FIFO_Samples, F_DEPTH);
+    uint32_t Worst_Error_us = 0;
+
+    for (int i = 0; i < Drained; i++)
+    {
+        int32_t Error_us = (int32_t)(FIFO_Samples[i].Timestamp_us - (Activation_us + MPL.MPL_Conversion_Time_us() + i * MPL.MPL_Time_Step_us()));
+        uint32_t Magnitude_us = (Error_us < 0) ? (uint32_t)(-Error_us) : (uint32_t)Error_us;
+
+        Worst_Error_us = (Magnitude_us > Worst_Error_us) ? Magnitude_us : Worst_Error_us;
+    }
+
+    MPL.MPL_Stop_Continuous();
+    MPL.MPL_Set_FIFO_Mode(F_SETUP_F_MODE_DISABLED, 0);
+    printf("\nFIFO overflow after 40 s, %d samples: timestamp error <= %lu us\n", Drained, (unsigned long)Worst_Error_us);
+
+    // Low-power acquisition at 1 Hz: the core sleeps between sensor interrupts. Duty cycle of the MCU.
+    MPL_Duty_Cycle Duty;
+    static const char *Low_Power_Names[3] = {"Low power 1 Hz, Data Ready, sleep()", "Low power 1 Hz, FIFO watermark 8, sleep()", "Low power 1 Hz, FIFO watermark 8, deep"};
+
+    MPL.MPL_Set_Oversampling(16);
+
+    for (int Case = 0; Case < 3; Case++)
+    {
+        Begin();
+        MPL.MPL_Start_Low_Power(1, (Case == 0) ? 0 : 8);
+
+        for (int Samples = 0; Samples < 32; )
+        {
+            Samples += MPL.MPL_Sleep_Until_Samples(FIFO_Samples, F_DEPTH, (Case == 2));
+        }
+
+        MPL.MPL_Get_Duty_Cycle(Duty);
+        MPL.MPL_Stop_Low_Power();
+        End(Low_Power_Names[Case]);
+        printf("%-44s %lu wake-ups, awake %lu ppm\n", "", (unsigned long)Duty.Wakeups, (unsigned long)Duty.Awake_ppm);
+    }
+
+    // Compact log: one hour of 1 Hz OS128 samples drained from the FIFO, against one text line per reading. Read back,
+    // then again with one byte flipped in the middle of the file.
+    static MPL_Sample Logged[3600];
+    FILE *Log_File = tmpfile();
+    MPL3115A2_Log Log(Log_File);
+    unsigned long Text_Bytes = 0;
+    char Line[64];
+
+    MPL.MPL_Set_Oversampling(128);
+    MPL.MPL_Set_FIFO_Mode(F_SETUP_F_MODE_CIRCULAR, 0);
+    Sim.Set_Noise(2.0);
+    Sim.Set_Climb_Rate(0.5);
+    MPL.MPL_Start_Continuous(1);
+
+    for (int Count = 0; Count < 3600; )
+    {
+        wait(30.0f);
+        int Drained = MPL.MPL_Drain_FIFO(&Logged[Count], (3600 - Count < F_DEPTH) ? (3600 - Count) : F_DEPTH);
+
+        Log.Write(&Logged[Count], Drained);
+
+        for (int i = Count; i < Count + Drained; i++)
+        {
+            Text_Bytes += sprintf(Line, "%lu,%f,%f\n", (unsigned long)Logged[i].Timestamp_us, Logged[i].Pressure, Logged[i].Temperature);
+        }
+
+        Count += Drained;
+    }
+
+    Log.Flush();
+    MPL.MPL_Stop_Continuous();
+    MPL.MPL_Set_FIFO_Mode(F_SETUP_F_MODE_DISABLED, 0);
+    Sim.Set_Climb_Rate(0.0);
+    Sim.Set_Noise(0.0);
+
+    for (int Pass = 0; Pass < 2; Pass++)
+    {
+        if (Pass == 1)   // Flip one byte in the middle of the file.
+        {
+            fseek(Log_File, (long)(Log.Bytes() / 2), SEEK_SET);
+            int Byte_In_File = fgetc(Log_File);
+            fseek(Log_File, (long)(Log.Bytes() / 2), SEEK_SET);
+            fputc(Byte_In_File ^ 0x10, Log_File);
+            fflush(Log_File);
+        }
+
+        rewind(Log_File);
+
+        MPL3115A2_Log_Reader Reader(Log_File);
+        MPL_Log_Record Record;
+        int Read_Back = 0, Mismatches = 0;
+        uint32_t Worst_Time_us = 0;
+
+        while (Reader.Next(Record))
+        {
+            int i = Read_Back;
+
+            while ((i < 3600) && (Logged[i].Timestamp_us < Record.Timestamp_us) && ((Record.Timestamp_us - Logged[i].Timestamp_us) >= MPL_LOG_TIME_UNIT_US))
+            {
+                i++;   // Samples of a skipped block.
+            }
+
+            if ((i >= 3600) || (memcmp(Record.Raw, Logged[i].Raw, 5) != 0))
+            {
+                Mismatches++;
+                continue;
+            }
+
+            Worst_Time_us = (Logged[i].Timestamp_us - Record.Timestamp_us > Worst_Time_us) ? (Logged[i].Timestamp_us - Record.Timestamp_us) : Worst_Time_us;
+            Read_Back = i + 1;
+        }
+
+        if (Pass == 0)
+        {
+            printf("\nLog, %lu samples: %lu bytes (%.2f B/sample) in %lu writes, text %lu bytes in %lu writes: %.1fx smaller\n",
+                   (unsigned long)Log.Samples(), (unsigned long)Log.Bytes(), (double)Log.Bytes() / Log.Samples(), (unsigned long)Log.Blocks(),
+                   Text_Bytes, (unsigned long)Log.Samples(), (double)Text_Bytes / Log.Bytes());
+        }
+
+        printf("%-44s %lu blocks, %lu bad, %lu bytes skipped, last sample %d, %d mismatches, time error <= %lu us\n",
+               (Pass == 0) ? "  read back" : "  read back, 1 byte flipped", (unsigned long)Reader.Blocks(), (unsigned long)Reader.Bad_Blocks(),
+               (unsigned long)Reader.Skipped_Bytes(), Read_Back, Mismatches, (unsigned long)Worst_Time_us);
+
+        if (Pass == 0)
+        {
+            Check((Mismatches == 0) && (Read_Back == 3600) && (Reader.Bad_Blocks() == 0) && (Reader.Lost_Blocks() == 0), "log read-back");
+        }
+    }
+
+    fclose(Log_File);
+
+    // Non-blocking sample: trigger, conversion wait and burst read chained in transfer and timer callbacks. With the
+    // Data Ready interrupt the burst read is started from the pin interrupt.
+    bool Async_Results[2];
+
+    MPL.MPL_Set_Oversampling(16);
+    BENCH("MPL_Start_Sample OS16 (async, OST check)", Async_Results[0] = Async_Read_Sample(MPL, Sample));
+    MPL.MPL_Enable_Data_Ready_Interrupt(true);
+    BENCH("MPL_Start_Sample OS16 (async, interrupt)", Async_Results[1] = Async_Read_Sample(MPL, Frame.Current));
+    MPL.MPL_Disable_Data_Ready_Interrupt();
+    printf("%-44s Done(%s, %s), %.2f and %.2f Pa\n", "", Async_Results[0] ? "true" : "false", Async_Results[1] ? "true" : "false",
+           Sample.Pressure, Frame.Current.Pressure);
+    Check(Async_Results[0] && Async_Results[1], "asynchronous sample completion");
+
+    // Sample ring fed from the completion callback: a consumer that keeps up, then one that stalls past the capacity.
+    int Ring_Popped[2], Ring_Out_Of_Order[2];
+    uint32_t Ring_Peak[2], Ring_Dropped[2];
+
+    Ring_Sensor = &MPL;
+
+    for (int Pass = 0; Pass < 2; Pass++)
+    {
+        Ring_Out_Of_Order[Pass] = Ring_Check((Pass == 0) ? 24 : 12, (Pass == 1), Ring_Popped[Pass]);
+        Ring_Peak[Pass] = Ring.Peak_Count();
+        Ring_Dropped[Pass] = Ring.Overflow_Count();
+    }
+
+    printf("MPL_Sample_Ring<8> from Done(): %d of 24 popped, %d out of order, %lu dropped, peak %lu\n", Ring_Popped[0], Ring_Out_Of_Order[0],
+           (unsigned long)Ring_Dropped[0], (unsigned long)Ring_Peak[0]);
+    printf("  consumer stalled:               %d of 12 popped, %d out of order, %lu dropped, peak %lu\n", Ring_Popped[1], Ring_Out_Of_Order[1],
+           (unsigned long)(Ring_Dropped[1] - Ring_Dropped[0]), (unsigned long)Ring_Peak[1]);
+    Check((Ring_Out_Of_Order[0] == 0) && (Ring_Popped[0] == 24) && (Ring_Dropped[0] == 0), "sample ring, consumer keeping up");
+    Check((Ring_Out_Of_Order[1] == 0) && (Ring_Popped[1] == 8) && ((Ring_Dropped[1] - Ring_Dropped[0]) == 4), "sample ring, consumer stalled: 8 kept, 4 dropped");
+
+    // Batch decoder: the vector kernel of this build against the scalar reference, on pseudo-random raw samples.
+    static char Raw[4099 * MPL_RAW_SAMPLE_BYTES];
+    static int32_t Value_A[4099], Value_B[4099], Temperature_A[4099], Temperature_B[4099];
+    uint32_t Seed = 1;
+    int Mismatches = 0;
+
+    for (unsigned i = 0; i < sizeof(Raw); i++)
+    {
+        Seed = Seed * 1664525UL + 1013904223UL;
+        Raw[i] = (char)(Seed >> 24);
+    }
+
+    MPL_Decode_Batch_Altitude(Raw, 4099, Value_A, Temperature_A);
+    MPL_Decode_Batch_Altitude_Scalar(Raw, 4099, Value_B, Temperature_B);
+    Mismatches += (memcmp(Value_A, Value_B, sizeof(Value_A)) != 0) + (memcmp(Temperature_A, Temperature_B, sizeof(Temperature_A)) != 0);
+
+    MPL_Decode_Batch_Pressure(Raw, 4099, Value_A, Temperature_A);
+    MPL_Decode_Batch_Pressure_Scalar(Raw, 4099, Value_B, Temperature_B);
+    Mismatches += (memcmp(Value_A, Value_B, sizeof(Value_A)) != 0) + (memcmp(Temperature_A, Temperature_B, sizeof(Temperature_A)) != 0);
+
+    printf("\nMPL_Decode_Batch (%s) vs. scalar: %s\n", MPL_Decode_Batch_Kernel(), (Mismatches == 0) ? "bit-identical" : "MISMATCH");
+    Check(Mismatches == 0, "batch decoder bit-identity");
+
+#ifdef MPL3115A2_BUS_STATS
+    MPL_Bus_Stats Stats;
+    MPL.MPL_Get_Bus_Stats(Stats);
+
+    printf("\n%-8s %9s %9s %6s\n", "register", "xfers", "bytes", "nacks");
+
+    for (int i = 0; i < MPL_BUS_STATS_REGISTERS; i++)
+    {
+        if (Stats.Transfers[i] != 0)
+        {
+            printf("0x%02X     %9lu %9lu %6lu\n", i, (unsigned long)Stats.Transfers[i], (unsigned long)Stats.Bytes[i], (unsigned long)Stats.Nacks[i]);
+        }
+    }
+
+    printf("total    %9lu %9lu %6lu  %lu us\n\n", (unsigned long)Stats.Total_Transfers, (unsigned long)Stats.Total_Bytes,
+           (unsigned long)Stats.Total_Nacks, (unsigned long)Stats.Total_Time_us);
+
+    for (int i = 0; i < MPL_BUS_STATS_BUCKETS; i++)
+    {
+        if (Stats.Latency[i] != 0)
+        {
+            printf("< %6lu us %9lu\n", 1UL << i, (unsigned long)Stats.Latency[i]);
+        }
+    }
+#endif
+
+    return (Failures == 0) ? 0 : 1;
+}
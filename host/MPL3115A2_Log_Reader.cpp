@@ -0,0 +1,159 @@
+#include "MPL3115A2_Log_Reader.h"
+#include "MPL3115A2_Decode.h"
+#include <string.h>
+
+
+MPL3115A2_Log_Reader::MPL3115A2_Log_Reader(FILE *File)
+{
+    this->File = File;
+
+    Buffered = 0;
+    Payload_Length = 0;
+    Position = 0;
+    Remaining = 0;
+    Have_Sequence = false;
+
+    Block_Count = 0;
+    Bad_Count = 0;
+    Lost_Count = 0;
+    Skipped_Count = 0;
+}
+
+bool MPL3115A2_Log_Reader::Next(MPL_Log_Record &Record)  // The first sample of a block comes from the header, the others from the payload records.
+{
+    if (Remaining == 0)
+    {
+        if (Load_Block() == false)
+        {
+            return false;
+        }
+
+        Pressure = MPL_Log_Pressure_Field(&Block[14]);
+        Temperature = MPL_Log_Temperature_Field(&Block[17]);
+        Units = 0;
+        Step = 0;
+    }
+
+    else
+    {
+        uint32_t Code[3];
+        int Available = MPL_LOG_HEADER_BYTES + Payload_Length;
+
+        for (int i = 0; i < 3; i++)
+        {
+            int Length = MPL_Log_Get_Varint(&Block[Position], Available - Position, Code[i]);
+
+            if (Length == 0)   // Only a writer bug gets here: the CRC matched. Drop the rest of the block.
+            {
+                Remaining = 0;
+                return Next(Record);
+            }
+
+            Position += Length;
+        }
+
+        Pressure = (Pressure + (uint32_t)MPL_Log_Unzigzag(Code[0])) & 0xFFFFF;
+        Temperature = (Temperature + (uint32_t)MPL_Log_Unzigzag(Code[1])) & 0xFFF;
+        Step += (uint32_t)MPL_Log_Unzigzag(Code[2]);
+        Units += Step;
+    }
+
+    Remaining--;
+
+    MPL_Log_Put_Fields(Record.Raw, Pressure, Temperature);
+    Record.Bar_Mode = Bar_Mode;
+    Record.Timestamp_us = First_us + Units * MPL_LOG_TIME_UNIT_US;
+    Record.Sequence = Sequence;
+    Record.Value_Fixed = Bar_Mode ? MPL_Decode_Pressure(&Record.Raw[0]) : MPL_Decode_Altitude(&Record.Raw[0]);
+    Record.Temperature_Fixed = MPL_Decode_Temperature(&Record.Raw[3]);
+
+    return true;
+}
+
+bool MPL3115A2_Log_Reader::Load_Block()  // Slide over the file one byte at a time until a header checks out.
+{
+    while (true)
+    {
+        int Available = Fill();
+
+        if (Available < MPL_LOG_HEADER_BYTES)
+        {
+            Skipped_Count += Available;   // Trailing bytes: a block cut short by a power loss.
+            Consume(Available);
+            return false;
+        }
+
+        bool Header_Valid = ((uint8_t)Buffer[0] == MPL_LOG_MAGIC_0) && ((uint8_t)Buffer[1] == MPL_LOG_MAGIC_1) && (Buffer[2] == MPL_LOG_VERSION)
+                            && (MPL_Log_Get_16(&Buffer[6]) != 0) && ((int)MPL_Log_Get_16(&Buffer[8]) <= (MPL_LOG_BLOCK_BYTES - MPL_LOG_HEADER_BYTES));
+
+        if (Header_Valid)
+        {
+            int Length = (int)MPL_Log_Get_16(&Buffer[8]);
+
+            if ((Available >= (MPL_LOG_HEADER_BYTES + Length)) && (MPL_Log_CRC_Block(Buffer, Length) == MPL_Log_Get_32(&Buffer[MPL_LOG_CRC_OFFSET])))
+            {
+                memcpy(Block, Buffer, MPL_LOG_HEADER_BYTES + Length);
+                Consume(MPL_LOG_HEADER_BYTES + Length);
+
+                uint16_t Block_Sequence = (uint16_t)MPL_Log_Get_16(&Block[4]);
+
+                if (Have_Sequence)
+                {
+                    Lost_Count += (uint16_t)(Block_Sequence - Sequence - 1);   // 0 when in order. A fresh log appended to an old one shows up here too.
+                }
+
+                Sequence = Block_Sequence;
+                Have_Sequence = true;
+                Bar_Mode = ((Block[3] & MPL_LOG_FLAG_BAR_MODE) != 0);
+                First_us = MPL_Log_Get_32(&Block[10]);
+                Payload_Length = Length;
+                Position = MPL_LOG_HEADER_BYTES;
+                Remaining = (int)MPL_Log_Get_16(&Block[6]);
+                Block_Count++;
+
+                return true;
+            }
+
+            Bad_Count++;
+        }
+
+        Skipped_Count++;
+        Consume(1);
+    }
+}
+
+int MPL3115A2_Log_Reader::Fill()
+{
+    if (Buffered < MPL_LOG_BLOCK_BYTES)
+    {
+        Buffered += (int)fread(&Buffer[Buffered], 1, MPL_LOG_BLOCK_BYTES - Buffered, File);
+    }
+
+    return Buffered;
+}
+
+void MPL3115A2_Log_Reader::Consume(int Bytes)
+{
+    memmove(Buffer, &Buffer[Bytes], Buffered - Bytes);
+    Buffered -= Bytes;
+}
+
+uint32_t MPL3115A2_Log_Reader::Blocks()
+{
+    return Block_Count;
+}
+
+uint32_t MPL3115A2_Log_Reader::Bad_Blocks()
+{
+    return Bad_Count;
+}
+
+uint32_t MPL3115A2_Log_Reader::Lost_Blocks()
+{
+    return Lost_Count;
+}
+
+uint32_t MPL3115A2_Log_Reader::Skipped_Bytes()
+{
+    return Skipped_Count;
+}
@@ -0,0 +1,72 @@
+/*!
+ *   Host (Linux) reader of the compact block log written by MPL3115A2_Log.
+ *
+ *   Returns the samples one by one, oldest first. Blocks are checked against their CRC; a damaged or
+ *   truncated block is skipped and reading resumes at the next valid header, so a corrupted byte costs
+ *   at most one block. Sequence gaps (blocks the logger failed to write) are counted.
+ *
+*/
+
+#ifndef MPL3115A2_LOG_READER_H_
+#define MPL3115A2_LOG_READER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "MPL3115A2_Log_Format.h"
+
+struct MPL_Log_Record   // One logged sample.
+{
+    char Raw[5];            // OUT_P_MSB..OUT_T_LSB as read from the sensor (reserved low nibbles cleared)
+    bool Bar_Mode;          // 'true' - Raw holds a pressure, 'false' - an altitude
+    uint32_t Timestamp_us;  // us_ticker of the logger. Exact for the first sample of a block, within MPL_LOG_TIME_UNIT_US after it.
+    uint16_t Sequence;      // Block the sample came from
+    int32_t Value_Fixed;    // Q18.2 Pa in Barometer mode, Q16.4 m in Altimeter mode
+    int32_t Temperature_Fixed;  // Q8.4 C
+};
+
+class MPL3115A2_Log_Reader
+{
+
+public:
+
+    MPL3115A2_Log_Reader(FILE *File);  // Open in binary mode.
+
+    bool Next(MPL_Log_Record &Record);  // Returns 'false' at the end of the file.
+
+    uint32_t Blocks();         // Valid blocks read
+    uint32_t Bad_Blocks();     // Headers found with a wrong CRC or a truncated payload
+    uint32_t Lost_Blocks();    // Sequence numbers missing between valid blocks
+    uint32_t Skipped_Bytes();  // Bytes outside valid blocks
+
+private:
+
+    bool Load_Block();   // Find, check and take the next valid block.
+    int Fill();          // Top up Buffer from the file. Returns the bytes available.
+    void Consume(int Bytes);
+
+    FILE *File;
+    char Buffer[MPL_LOG_BLOCK_BYTES];
+    int Buffered;
+
+    char Block[MPL_LOG_BLOCK_BYTES];   // Block being returned
+    int Payload_Length;
+    int Position;                      // Next record in Block
+    int Remaining;                     // Samples of Block still to return
+
+    bool Bar_Mode;
+    uint16_t Sequence;
+    bool Have_Sequence;
+    uint32_t First_us;
+    uint32_t Pressure;                 // 20-bit field of the previous sample
+    uint32_t Temperature;              // 12-bit field of the previous sample
+    uint32_t Units;                    // Time units since First_us
+    uint32_t Step;                     // Time units between the last two samples
+
+    uint32_t Block_Count;
+    uint32_t Bad_Count;
+    uint32_t Lost_Count;
+    uint32_t Skipped_Count;
+
+};
+
+#endif
@@ -0,0 +1,463 @@
+#include "MPL3115A2_Sim.h"
+
+#define SIM_SEA_LEVEL_PA   101325.0
+#define SIM_ALT_SCALE_M    44330.77    // Barometric formula used by the device: h = 44330.77 * (1 - (P / P0)^0.1902632)
+#define SIM_ALT_EXPONENT   0.1902632
+
+static const uint16_t Conversion_Time_ms[8] = {6, 10, 18, 34, 66, 130, 258, 512};  // Same table as CTRL_REG1_OS_n in the register map.
+
+
+MPL3115A2_Sim::MPL3115A2_Sim(PinName sda)
+{
+    Int1_Pin = NC;
+    Int2_Pin = NC;
+    Base_Pressure_Pa = SIM_SEA_LEVEL_PA;
+    Base_Temperature_C = 21.5;
+    Climb_Rate = 0;
+    Base_us = 0;
+    Noise_Sigma = 0;
+    Noise_State = 12345;
+    Conversion_Count = 0;
+
+    Reset_Registers();
+
+    Sim_Attach(sda, this);
+}
+
+void MPL3115A2_Sim::Connect_INT1(PinName pin)
+{
+    Int1_Pin = pin;
+}
+
+void MPL3115A2_Sim::Connect_INT2(PinName pin)
+{
+    Int2_Pin = pin;
+}
+
+void MPL3115A2_Sim::Set_Environment(double Pressure_Pa, double Temperature_C)
+{
+    Base_Pressure_Pa = Pressure_Pa;
+    Base_Temperature_C = Temperature_C;
+    Base_us = Sim_Now_us();
+}
+
+void MPL3115A2_Sim::Set_Climb_Rate(double Meters_Per_Second)
+{
+    Base_Pressure_Pa = Pressure_At(Sim_Now_us());
+    Base_us = Sim_Now_us();
+    Climb_Rate = Meters_Per_Second;
+}
+
+void MPL3115A2_Sim::Set_Noise(double Pressure_Sigma_Pa)
+{
+    Noise_Sigma = Pressure_Sigma_Pa;
+}
+
+uint32_t MPL3115A2_Sim::Conversions()
+{
+    return Conversion_Count;
+}
+
+void MPL3115A2_Sim::Reset_Registers()  // Power-on / CTRL_REG1_RST defaults.
+{
+    memset(Reg, 0, sizeof(Reg));
+    Reg[WHO_AM_I] = (char)0xC4;
+    Reg[BAR_IN_MSB] = (char)0xC5;
+    Reg[BAR_IN_LSB] = (char)0xE7;
+
+    Pointer = 0;
+    FIFO_Count = 0;
+    FIFO_Read_Byte = 0;
+    P_Min_Valid = P_Max_Valid = T_Min_Valid = T_Max_Valid = false;
+    Last_P = 0;
+    Last_T = 0;
+    OST_Done_us = 0;
+    Next_Step_us = 0;
+
+    Update_Interrupt_Pads();
+}
+
+int MPL3115A2_Sim::Sim_Address()
+{
+    return MPL3115A2_WRITE;
+}
+
+char MPL3115A2_Sim::Next_Address(char Address)  // Auto-increment column of MPL3115A2_REGISTER_MAP.h
+{
+    bool FIFO_On = ((Reg[F_SETUP] & ~F_SETUP_F_WMRK) != 0);
+
+    if (FIFO_On && ((Address == OUT_P_MSB) || (Address == F_DATA))) { return Address; }
+    if (Address == OUT_T_LSB)       { return STATUS; }
+    if (Address == OUT_T_DELTA_LSB) { return DR_STATUS; }
+    if (Address == OFF_H)           { return WHO_AM_I; }
+
+    return Address + 1;
+}
+
+void MPL3115A2_Sim::Sim_Write(const char *data, int length)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+
+    Pointer = data[0];
+
+    for (int i = 1; i < length; i++)
+    {
+        Write_Register(Pointer, data[i]);
+        Pointer = Next_Address(Pointer);
+    }
+}
+
+void MPL3115A2_Sim::Sim_Read(char *data, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        data[i] = Read_Register(Pointer);
+        Pointer = Next_Address(Pointer);
+    }
+}
+
+void MPL3115A2_Sim::Write_Register(char Address, char Value)
+{
+    if ((unsigned char)Address > OFF_H)
+    {
+        return;
+    }
+
+    switch (Address)
+    {
+        case CTRL_REG1:
+        {
+            char Old = Reg[CTRL_REG1];
+
+            if ((Value & CTRL_REG1_RST) != 0)
+            {
+                Reset_Registers();
+                return;
+            }
+
+            Reg[CTRL_REG1] = Value;
+
+            if (((Value & CTRL_REG1_OST) != 0) && ((Old & CTRL_REG1_OST) == 0) && (OST_Done_us == 0))
+            {
+                OST_Done_us = Sim_Now_us() + Conversion_Time_us();
+            }
+
+            if (((Value & CTRL_REG1_SBYB) != 0) && ((Old & CTRL_REG1_SBYB) == 0))
+            {
+                Next_Step_us = Sim_Now_us() + Conversion_Time_us();
+            }
+
+            if ((Value & CTRL_REG1_SBYB) == 0)
+            {
+                Next_Step_us = 0;
+            }
+
+            break;
+        }
+
+        case F_SETUP:
+            Reg[F_SETUP] = Value;
+            Reg[TIME_DLY] = 0;
+
+            if ((Value & ~F_SETUP_F_WMRK) == F_SETUP_F_MODE_DISABLED)  // Disabling flushes the FIFO.
+            {
+                FIFO_Count = 0;
+                FIFO_Read_Byte = 0;
+                Reg[F_STATUS] = 0;
+            }
+            break;
+
+        case P_MIN_MSB: case P_MIN_CSB: case P_MIN_LSB: Reg[(unsigned char)Address] = Value; P_Min_Valid = false; break;
+        case P_MAX_MSB: case P_MAX_CSB: case P_MAX_LSB: Reg[(unsigned char)Address] = Value; P_Max_Valid = false; break;
+        case T_MIN_MSB: case T_MIN_LSB:                 Reg[(unsigned char)Address] = Value; T_Min_Valid = false; break;
+        case T_MAX_MSB: case T_MAX_LSB:                 Reg[(unsigned char)Address] = Value; T_Max_Valid = false; break;
+
+        case CTRL_REG3: case CTRL_REG4: case CTRL_REG5:
+            Reg[(unsigned char)Address] = Value;
+            Update_Interrupt_Pads();
+            break;
+
+        default:
+            if ((unsigned char)Address >= PT_DATA_CFG)  // Read-only registers below PT_DATA_CFG ignore writes.
+            {
+                Reg[(unsigned char)Address] = Value;
+            }
+            break;
+    }
+}
+
+char MPL3115A2_Sim::Read_Register(char Address)
+{
+    bool FIFO_On = ((Reg[F_SETUP] & ~F_SETUP_F_WMRK) != 0);
+
+    if ((unsigned char)Address > OFF_H)
+    {
+        return 0;
+    }
+
+    if (FIFO_On && ((Address == OUT_P_MSB) || (Address == F_DATA)))  // FIFO pop
+    {
+        if (FIFO_Count == 0)
+        {
+            return 0;
+        }
+
+        char Value = FIFO[FIFO_Read_Byte];
+
+        FIFO_Read_Byte++;
+
+        if (FIFO_Read_Byte == F_SAMPLE_BYTES)
+        {
+            memmove(FIFO, FIFO + F_SAMPLE_BYTES, (FIFO_Count - 1) * F_SAMPLE_BYTES);
+            FIFO_Count--;
+            FIFO_Read_Byte = 0;
+            Reg[F_STATUS] = (Reg[F_STATUS] & ~F_STATUS_F_CNT) | FIFO_Count;
+        }
+
+        return Value;
+    }
+
+    if (Address == STATUS)
+    {
+        return FIFO_On ? Reg[F_STATUS] : Reg[DR_STATUS];
+    }
+
+    char Value = Reg[(unsigned char)Address];
+
+    if (Address == OUT_P_MSB)
+    {
+        Reg[DR_STATUS] &= ~(DR_PDR | DR_POW | DR_PTDR | DR_PTOW);
+        Reg[INT_SOURCE] &= ~SRC_DRDY;
+        Update_Interrupt_Pads();
+    }
+
+    if (Address == OUT_T_MSB)
+    {
+        Reg[DR_STATUS] &= ~(DR_TDR | DR_TOW | DR_PTDR | DR_PTOW);
+        Reg[INT_SOURCE] &= ~SRC_DRDY;
+        Update_Interrupt_Pads();
+    }
+
+    if (Address == F_STATUS)
+    {
+        Reg[F_STATUS] &= ~(F_STATUS_F_OVF | F_STATUS_F_WMRK_FLAG);
+        Reg[INT_SOURCE] &= ~SRC_FIFO;
+        Update_Interrupt_Pads();
+    }
+
+    return Value;
+}
+
+uint64_t MPL3115A2_Sim::Conversion_Time_us()
+{
+    return (uint64_t)Conversion_Time_ms[(Reg[CTRL_REG1] & CTRL_REG1_OS_128) >> 3] * 1000;
+}
+
+double MPL3115A2_Sim::Pressure_At(uint64_t t_us)
+{
+    double h0 = SIM_ALT_SCALE_M * (1.0 - pow(Base_Pressure_Pa / SIM_SEA_LEVEL_PA, SIM_ALT_EXPONENT));
+    double h = h0 + Climb_Rate * (double)(t_us - Base_us) / 1000000.0;
+
+    return SIM_SEA_LEVEL_PA * pow(1.0 - h / SIM_ALT_SCALE_M, 1.0 / SIM_ALT_EXPONENT);
+}
+
+double MPL3115A2_Sim::Noise()  // Deterministic, roughly normal: sum of four uniforms.
+{
+    double Sum = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        Noise_State = Noise_State * 1664525u + 1013904223u;
+        Sum += (double)(Noise_State >> 8) / 16777216.0;
+    }
+
+    return (Sum - 2.0) * 1.7320508;
+}
+
+void MPL3115A2_Sim::Complete_Conversion()
+{
+    int OS = 1 << ((Reg[CTRL_REG1] & CTRL_REG1_OS_128) >> 3);
+    uint64_t Now = Sim_Now_us();
+
+    double P = Pressure_At(Now) + (Noise_Sigma / sqrt((double)OS)) * Noise() + 4.0 * (signed char)Reg[OFF_P];
+    double T = Base_Temperature_C + 0.0625 * (signed char)Reg[OFF_T];
+
+    int32_t Out;
+
+    if ((Reg[CTRL_REG1] & CTRL_REG1_ALT) != 0)
+    {
+        double P0 = 2.0 * (double)(((uint8_t)Reg[BAR_IN_MSB] << 8) | (uint8_t)Reg[BAR_IN_LSB]);
+        double h = SIM_ALT_SCALE_M * (1.0 - pow(P / P0, SIM_ALT_EXPONENT)) + (signed char)Reg[OFF_H];
+
+        Out = (int32_t)floor(h * 16.0 + 0.5);
+    }
+
+    else
+    {
+        Out = (int32_t)floor(P * 4.0 + 0.5);
+    }
+
+    int32_t T_Out = (int32_t)floor(T * 16.0 + 0.5);
+
+    Out &= 0x000FFFFF;
+    T_Out &= 0x00000FFF;
+
+    Reg[OUT_P_MSB] = (char)(Out >> 12);
+    Reg[OUT_P_CSB] = (char)(Out >> 4);
+    Reg[OUT_P_LSB] = (char)((Out & 0x0F) << 4);
+    Reg[OUT_T_MSB] = (char)(T_Out >> 4);
+    Reg[OUT_T_LSB] = (char)((T_Out & 0x0F) << 4);
+
+    int32_t dP = (Out - Last_P) & 0x000FFFFF;
+    int32_t dT = (T_Out - Last_T) & 0x00000FFF;
+
+    Reg[OUT_P_DELTA_MSB] = (char)(dP >> 12);
+    Reg[OUT_P_DELTA_CBS] = (char)(dP >> 4);
+    Reg[OUT_P_DELTA_LSB] = (char)((dP & 0x0F) << 4);
+    Reg[OUT_T_DELTA_MSB] = (char)(dT >> 4);
+    Reg[OUT_T_DELTA_LSB] = (char)((dT & 0x0F) << 4);
+
+    Last_P = Out;
+    Last_T = T_Out;
+
+    char DR = Reg[DR_STATUS];
+
+    if ((DR & DR_PDR) != 0)  { DR |= DR_POW; }
+    if ((DR & DR_TDR) != 0)  { DR |= DR_TOW; }
+    if ((DR & DR_PTDR) != 0) { DR |= DR_PTOW; }
+
+    Reg[DR_STATUS] = DR | DR_PDR | DR_TDR | DR_PTDR;
+
+    // Min/Max registers compare sign-extended values in Altimeter mode, unsigned in Barometer mode.
+    bool Signed_P = ((Reg[CTRL_REG1] & CTRL_REG1_ALT) != 0);
+    int32_t P_Cmp = (Signed_P && ((Out & 0x00080000) != 0)) ? (Out | (int32_t)0xFFF00000) : Out;
+    int32_t T_Cmp = ((T_Out & 0x800) != 0) ? (T_Out | (int32_t)0xFFFFF000) : T_Out;
+
+    int32_t P_Min = (((uint8_t)Reg[P_MIN_MSB] << 12) | ((uint8_t)Reg[P_MIN_CSB] << 4) | ((uint8_t)Reg[P_MIN_LSB] >> 4));
+    int32_t P_Max = (((uint8_t)Reg[P_MAX_MSB] << 12) | ((uint8_t)Reg[P_MAX_CSB] << 4) | ((uint8_t)Reg[P_MAX_LSB] >> 4));
+    int32_t T_Min = (((uint8_t)Reg[T_MIN_MSB] << 4) | ((uint8_t)Reg[T_MIN_LSB] >> 4));
+    int32_t T_Max = (((uint8_t)Reg[T_MAX_MSB] << 4) | ((uint8_t)Reg[T_MAX_LSB] >> 4));
+
+    if (Signed_P && ((P_Min & 0x00080000) != 0)) { P_Min |= (int32_t)0xFFF00000; }
+    if (Signed_P && ((P_Max & 0x00080000) != 0)) { P_Max |= (int32_t)0xFFF00000; }
+    if ((T_Min & 0x800) != 0) { T_Min |= (int32_t)0xFFFFF000; }
+    if ((T_Max & 0x800) != 0) { T_Max |= (int32_t)0xFFFFF000; }
+
+    if (!P_Min_Valid || (P_Cmp < P_Min)) { Reg[P_MIN_MSB] = Reg[OUT_P_MSB]; Reg[P_MIN_CSB] = Reg[OUT_P_CSB]; Reg[P_MIN_LSB] = Reg[OUT_P_LSB]; P_Min_Valid = true; }
+    if (!P_Max_Valid || (P_Cmp > P_Max)) { Reg[P_MAX_MSB] = Reg[OUT_P_MSB]; Reg[P_MAX_CSB] = Reg[OUT_P_CSB]; Reg[P_MAX_LSB] = Reg[OUT_P_LSB]; P_Max_Valid = true; }
+    if (!T_Min_Valid || (T_Cmp < T_Min)) { Reg[T_MIN_MSB] = Reg[OUT_T_MSB]; Reg[T_MIN_LSB] = Reg[OUT_T_LSB]; T_Min_Valid = true; }
+    if (!T_Max_Valid || (T_Cmp > T_Max)) { Reg[T_MAX_MSB] = Reg[OUT_T_MSB]; Reg[T_MAX_LSB] = Reg[OUT_T_LSB]; T_Max_Valid = true; }
+
+    // FIFO: fills in ACTIVE mode only.
+    char F_Mode = Reg[F_SETUP] & ~F_SETUP_F_WMRK;
+
+    if ((F_Mode != F_SETUP_F_MODE_DISABLED) && ((Reg[CTRL_REG1] & CTRL_REG1_SBYB) != 0))
+    {
+        bool Store = true;
+
+        if (FIFO_Count == F_DEPTH)
+        {
+            Reg[F_STATUS] |= F_STATUS_F_OVF;
+            Reg[INT_SOURCE] |= SRC_FIFO;
+
+            if (F_Mode == F_SETUP_F_MODE_CIRCULAR)  // Drop the oldest sample.
+            {
+                memmove(FIFO, FIFO + F_SAMPLE_BYTES, (F_DEPTH - 1) * F_SAMPLE_BYTES);
+                FIFO_Count--;
+                FIFO_Read_Byte = 0;
+            }
+
+            else                                    // Stop mode: keep the old samples, count the time since the last write.
+            {
+                Store = false;
+
+                if ((uint8_t)Reg[TIME_DLY] < 0xFF)
+                {
+                    Reg[TIME_DLY]++;
+                }
+            }
+        }
+
+        if (Store)
+        {
+            memcpy(&FIFO[FIFO_Count * F_SAMPLE_BYTES], &Reg[OUT_P_MSB], F_SAMPLE_BYTES);
+            FIFO_Count++;
+        }
+
+        Reg[F_STATUS] = (Reg[F_STATUS] & ~F_STATUS_F_CNT) | FIFO_Count;
+
+        char Watermark = Reg[F_SETUP] & F_SETUP_F_WMRK;
+
+        if ((Watermark != 0) && (FIFO_Count >= Watermark))
+        {
+            Reg[F_STATUS] |= F_STATUS_F_WMRK_FLAG;
+            Reg[INT_SOURCE] |= SRC_FIFO;
+        }
+    }
+
+    Reg[INT_SOURCE] |= SRC_DRDY;
+    Conversion_Count++;
+
+    Update_Interrupt_Pads();
+}
+
+void MPL3115A2_Sim::Update_Interrupt_Pads()  // INT_SOURCE bits map 1:1 onto the CTRL_REG4 enables and CTRL_REG5 routing bits.
+{
+    char Active = Reg[INT_SOURCE] & Reg[CTRL_REG4];
+    bool INT1_Asserted = ((Active & Reg[CTRL_REG5]) != 0);
+    bool INT2_Asserted = ((Active & ~Reg[CTRL_REG5]) != 0);
+    bool IPOL1 = ((Reg[CTRL_REG3] & CTRL_REG3_IPOL1) != 0);
+    bool IPOL2 = ((Reg[CTRL_REG3] & CTRL_REG3_IPOL2) != 0);
+
+    InterruptIn *Pin1 = (Int1_Pin != NC) ? InterruptIn::Sim_Find(Int1_Pin) : NULL;
+    InterruptIn *Pin2 = (Int2_Pin != NC) ? InterruptIn::Sim_Find(Int2_Pin) : NULL;
+
+    if (Pin1 != NULL) { Pin1->Sim_Drive((INT1_Asserted == IPOL1) ? 1 : 0); }
+    if (Pin2 != NULL) { Pin2->Sim_Drive((INT2_Asserted == IPOL2) ? 1 : 0); }
+}
+
+void MPL3115A2_Sim::Sim_Process()
+{
+    uint64_t Now = Sim_Now_us();
+
+    while (true)
+    {
+        if ((OST_Done_us != 0) && (OST_Done_us <= Now) && ((Next_Step_us == 0) || (OST_Done_us <= Next_Step_us)))
+        {
+            OST_Done_us = 0;
+
+            if ((Reg[CTRL_REG1] & CTRL_REG1_SBYB) == 0)  // OST auto-clears in STANDBY only.
+            {
+                Reg[CTRL_REG1] &= ~CTRL_REG1_OST;
+            }
+
+            Complete_Conversion();
+        }
+
+        else if ((Next_Step_us != 0) && (Next_Step_us <= Now))
+        {
+            Next_Step_us += ((uint64_t)1 << (Reg[CTRL_REG2] & CTRL_REG2_ST)) * 1000000;
+            Complete_Conversion();
+        }
+
+        else
+        {
+            break;
+        }
+    }
+}
+
+uint64_t MPL3115A2_Sim::Sim_Next_Event_us()
+{
+    uint64_t Next = OST_Done_us;
+
+    if ((Next_Step_us != 0) && ((Next == 0) || (Next_Step_us < Next)))
+    {
+        Next = Next_Step_us;
+    }
+
+    return Next;
+}
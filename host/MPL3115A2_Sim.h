@@ -0,0 +1,67 @@
+#include "mbed.h"
+#ifndef MPL3115A2_SIM_H_
+#define MPL3115A2_SIM_H_
+
+#include "MPL3115A2_REGISTER_MAP.h"
+
+class MPL3115A2_Sim : public Sim_I2C_Device   // Register-level model of the MPL3115A2 behind the host I2C stand-in.
+{
+
+public:
+
+    MPL3115A2_Sim(PinName sda);
+
+    void Connect_INT1(PinName pin);  // MCU pin wired to the INT1 pad.
+    void Connect_INT2(PinName pin);  // MCU pin wired to the INT2 pad.
+
+    void Set_Environment(double Pressure_Pa, double Temperature_C);  // Conditions at the current simulated time.
+    void Set_Climb_Rate(double Meters_Per_Second);                    // Constant vertical speed from now on.
+    void Set_Noise(double Pressure_Sigma_Pa);                         // Pressure noise at OS = 1. Scaled by 1/sqrt(OS). Deterministic.
+
+    uint32_t Conversions();  // Completed acquisitions since the simulator was created.
+
+    // Sim_I2C_Device
+    virtual int Sim_Address();
+    virtual void Sim_Write(const char *data, int length);
+    virtual void Sim_Read(char *data, int length);
+    virtual void Sim_Process();
+    virtual uint64_t Sim_Next_Event_us();
+
+private:
+
+    void Reset_Registers();
+    char Next_Address(char Address);
+    void Write_Register(char Address, char Value);
+    char Read_Register(char Address);
+    void Complete_Conversion();
+    void Update_Interrupt_Pads();
+    double Pressure_At(uint64_t t_us);
+    double Noise();
+    uint64_t Conversion_Time_us();
+
+    char Reg[OFF_H + 1];
+    char Pointer;
+
+    char FIFO[F_DEPTH * F_SAMPLE_BYTES];
+    int FIFO_Count;       // Samples stored
+    int FIFO_Read_Byte;   // Bytes of the oldest sample already read through F_DATA
+
+    bool P_Min_Valid, P_Max_Valid, T_Min_Valid, T_Max_Valid;  // Cleared when the host writes the min/max registers
+    int32_t Last_P, Last_T;                                   // Previous output, for the delta registers
+
+    uint64_t OST_Done_us;   // End of the one-shot conversion in progress. 0 = none.
+    uint64_t Next_Step_us;  // Next periodic acquisition in ACTIVE mode. 0 = STANDBY.
+
+    double Base_Pressure_Pa, Base_Temperature_C, Climb_Rate;
+    uint64_t Base_us;
+    double Noise_Sigma;
+    uint32_t Noise_State;
+    uint32_t Conversion_Count;
+
+    InterruptIn *Int1;
+    InterruptIn *Int2;
+    PinName Int1_Pin, Int2_Pin;
+
+};
+
+#endif
@@ -0,0 +1,301 @@
+/*!
+ *   Host (Linux) stand-in for the parts of mbed used by the MPL3115A2 driver.
+ *
+ *   Time is virtual: it only advances with simulated I2C bus traffic, wait_*() calls and
+ *   __WFI(). Timeout callbacks fire when the virtual clock passes their deadline. I2C transfers are routed to the MPL3115A2_Sim attached to the SDA pin of the bus.
+ *   Every transfer is accounted in Sim_Bus (transactions, bytes, bus time).
+ *
+ *   DEVICE_I2C_ASYNCH is set, as on targets with an asynchronous I2C HAL: I2C::transfer() returns at once
+ *   and calls its event callback when the bus time of the transfer has elapsed, like the transfer-complete
+ *   interrupt would. The LPC1768 HAL has no asynchronous I2C; the driver leaves MPL_Start_Sample() out there.
+ *
+*/
+
+#ifndef MBED_H
+#define MBED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define DEVICE_I2C_ASYNCH 1
+
+typedef enum
+{
+    p5 = 5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15, p16, p17, p18,
+    p19, p20, p21, p22, p23, p24, p25, p26, p27, p28, p29, p30,
+    NC = -1
+} PinName;
+
+//=== Virtual time ===
+
+uint64_t Sim_Now_us();                 // Current simulated time.
+void Sim_Advance_us(uint64_t Delta);   // Move the clock forward and let attached devices process their events.
+
+uint32_t us_ticker_read();
+
+void wait(float s);
+void wait_ms(int ms);
+void wait_us(int us);
+
+void __WFI();        // Jumps to the next pending device event (or 1 ms ahead) and delivers its interrupts.
+void sleep();
+void deepsleep();
+
+void __disable_irq();   // No-ops: interrupts are only delivered while virtual time advances (bus traffic, waits, __WFI()),
+void __enable_irq();    // so a masked test-and-sleep behaves as on the target, the handler running before the loop re-checks.
+
+//=== Bus accounting ===
+
+struct Sim_Bus_Counters
+{
+    uint32_t Transactions;  // write()/read() calls (each START or repeated START)
+    uint32_t Bytes;         // Bytes on the wire including the address byte
+    uint32_t Nacks;         // Transfers not acknowledged
+    uint64_t Bus_Time_us;   // Simulated time the bus was busy
+};
+
+extern Sim_Bus_Counters Sim_Bus;
+
+void Sim_Bus_Reset();
+
+//=== Callback / InterruptIn ===
+
+template <typename F>
+class Callback;
+
+template <>
+class Callback<void()>   // Timeout and InterruptIn handlers.
+{
+
+public:
+
+    Callback(void (*func)() = 0) : Obj(0), Func(func), Thunk(0) {}
+
+    template <typename T>
+    Callback(T *obj, void (T::*method)()) : Obj(obj), Func(0), Thunk(&Method_Thunk<T>)
+    {
+        memcpy(Method, &method, sizeof(method));
+    }
+
+    operator bool() const { return (Func != 0) || (Thunk != 0); }
+
+    void operator()() const
+    {
+        if (Thunk != 0) { Thunk(Obj, Method); }
+        else if (Func != 0) { Func(); }
+    }
+
+private:
+
+    template <typename T>
+    static void Method_Thunk(void *obj, const char *method)
+    {
+        void (T::*m)();
+        memcpy(&m, method, sizeof(m));
+        (static_cast<T *>(obj)->*m)();
+    }
+
+    void *Obj;
+    void (*Func)();
+    void (*Thunk)(void *, const char *);
+    char Method[2 * sizeof(void *)];
+
+};
+
+template <typename A>
+class Callback<void(A)>   // One argument: event_callback_t (int) and the completion callback of MPL_Start_Sample() (bool).
+{
+
+public:
+
+    Callback(void (*func)(A) = 0) : Obj(0), Func(func), Thunk(0) {}
+
+    template <typename T>
+    Callback(T *obj, void (T::*method)(A)) : Obj(obj), Func(0), Thunk(&Method_Thunk<T>)
+    {
+        memcpy(Method, &method, sizeof(method));
+    }
+
+    operator bool() const { return (Func != 0) || (Thunk != 0); }
+
+    void operator()(A a) const
+    {
+        if (Thunk != 0) { Thunk(Obj, Method, a); }
+        else if (Func != 0) { Func(a); }
+    }
+
+private:
+
+    template <typename T>
+    static void Method_Thunk(void *obj, const char *method, A a)
+    {
+        void (T::*m)(A);
+        memcpy(&m, method, sizeof(m));
+        (static_cast<T *>(obj)->*m)(a);
+    }
+
+    void *Obj;
+    void (*Func)(A);
+    void (*Thunk)(void *, const char *, A);
+    char Method[2 * sizeof(void *)];
+
+};
+
+typedef Callback<void(int)> event_callback_t;
+
+class InterruptIn
+{
+
+public:
+
+    InterruptIn(PinName pin);
+    ~InterruptIn();
+
+    void rise(Callback<void()> func) { Rise = func; }
+    void fall(Callback<void()> func) { Fall = func; }
+
+    template <typename T, typename M>
+    void rise(T *obj, M method) { rise(Callback<void()>(obj, method)); }
+
+    template <typename T, typename M>
+    void fall(T *obj, M method) { fall(Callback<void()>(obj, method)); }
+
+    int read() { return Level; }
+
+    void Sim_Drive(int Level);  // Called by the simulated device when its interrupt pad changes.
+
+    static InterruptIn *Sim_Find(PinName pin);
+
+private:
+
+    PinName Pin;
+    int Level;
+    Callback<void()> Rise;
+    Callback<void()> Fall;
+
+};
+
+//=== Timer ===
+
+class Timer
+{
+
+public:
+
+    Timer() : Running(false), Start_us(0), Accumulated_us(0) {}
+
+    void start() { if (!Running) { Start_us = Sim_Now_us(); Running = true; } }
+    void stop()  { if (Running) { Accumulated_us += Sim_Now_us() - Start_us; Running = false; } }
+    void reset() { Start_us = Sim_Now_us(); Accumulated_us = 0; }
+
+    int read_us() { return (int)(Accumulated_us + (Running ? (Sim_Now_us() - Start_us) : 0)); }
+    int read_ms() { return read_us() / 1000; }
+    float read()  { return read_us() / 1000000.0f; }
+
+private:
+
+    bool Running;
+    uint64_t Start_us;
+    uint64_t Accumulated_us;
+
+};
+
+//=== Timeout ===
+
+class Timeout   // One-shot callback at a virtual time. Delivered by Sim_Advance_us() like a device event.
+{
+
+public:
+
+    Timeout() : Armed(false), Deadline_us(0) {}
+    ~Timeout() { detach(); }
+
+    void attach_us(Callback<void()> func, uint32_t t);
+    void attach(Callback<void()> func, float t) { attach_us(func, (uint32_t)(t * 1000000.0f)); }
+
+    template <typename T, typename M>
+    void attach_us(T *obj, M method, uint32_t t) { attach_us(Callback<void()>(obj, method), t); }
+
+    template <typename T, typename M>
+    void attach(T *obj, M method, float t) { attach(Callback<void()>(obj, method), t); }
+
+    void detach();
+
+    uint64_t Sim_Deadline_us() { return Armed ? Deadline_us : 0; }
+    void Sim_Fire();
+
+private:
+
+    bool Armed;
+    uint64_t Deadline_us;
+    Callback<void()> Func;
+
+};
+
+//=== I2C ===
+
+class Sim_I2C_Device   // Implemented by MPL3115A2_Sim.
+{
+
+public:
+
+    virtual ~Sim_I2C_Device() {}
+
+    virtual int Sim_Address() = 0;                       // 8-bit write address
+    virtual void Sim_Write(const char *data, int length) = 0;
+    virtual void Sim_Read(char *data, int length) = 0;
+    virtual void Sim_Process() = 0;                      // Handle events that are due at Sim_Now_us()
+    virtual uint64_t Sim_Next_Event_us() = 0;            // 0 when nothing is scheduled
+
+};
+
+void Sim_Attach(PinName sda, Sim_I2C_Device *Device);  // Put a device on the bus that uses this SDA pin.
+
+#define I2C_EVENT_ERROR               (1 << 1)
+#define I2C_EVENT_ERROR_NO_SLAVE      (1 << 2)
+#define I2C_EVENT_TRANSFER_COMPLETE   (1 << 3)
+#define I2C_EVENT_TRANSFER_EARLY_NACK (1 << 4)
+#define I2C_EVENT_ALL                 (I2C_EVENT_ERROR | I2C_EVENT_TRANSFER_COMPLETE | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK)
+
+class I2C
+{
+
+public:
+
+    I2C(PinName sda, PinName scl);
+
+    void frequency(int hz) { Hz = hz; }
+
+    int read(int address, char *data, int length, bool repeated = false);
+    int write(int address, const char *data, int length, bool repeated = false);
+
+    // Asynchronous write of tx_length bytes then, when rx_length != 0, repeated START and read of rx_length bytes. Returns 0
+    // when started, -1 while a previous transfer is in progress. The data moves and the callback runs (from the
+    // Timeout delivery, the interrupt context of the host) once the bus time of the whole transfer has elapsed.
+    int transfer(int address, const char *tx_buffer, int tx_length, void *rx_buffer, int rx_length, const event_callback_t &callback,
+                 int event = I2C_EVENT_TRANSFER_COMPLETE, bool repeated = false);
+
+private:
+
+    uint64_t Account(int Payload_Bytes, bool Acked);   // Returns the bus time of the transaction.
+    void Transfer_Done();
+
+    PinName Sda;
+    int Hz;
+
+    Timeout Transfer_Timer;        // Completion of the asynchronous transfer in progress
+    bool Transfer_Busy;
+    int Transfer_Address;
+    const char *Transfer_Tx;
+    int Transfer_Tx_Length;
+    char *Transfer_Rx;
+    int Transfer_Rx_Length;
+    event_callback_t Transfer_Callback;
+    int Transfer_Event;
+
+};
+
+#endif
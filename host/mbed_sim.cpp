@@ -0,0 +1,395 @@
+#include "mbed.h"
+
+#define SIM_MAX_DEVICES 8
+#define SIM_MAX_PINS    8
+#define SIM_MAX_TIMEOUTS 8
+
+static uint64_t Now_us = 0;
+
+static PinName Device_Sda[SIM_MAX_DEVICES];
+static Sim_I2C_Device *Devices[SIM_MAX_DEVICES];
+static int Device_Count = 0;
+
+static InterruptIn *Pins[SIM_MAX_PINS];
+static int Pin_Count = 0;
+
+static Timeout *Timeouts[SIM_MAX_TIMEOUTS];   // Armed timeouts only
+static int Timeout_Count = 0;
+
+Sim_Bus_Counters Sim_Bus;
+
+//=== Virtual time ===
+
+uint64_t Sim_Now_us()
+{
+    return Now_us;
+}
+
+static void Process_Devices()
+{
+    for (int i = 0; i < Device_Count; i++)
+    {
+        Devices[i]->Sim_Process();
+    }
+
+    for (int i = 0; i < Timeout_Count; i++)
+    {
+        if (Timeouts[i]->Sim_Deadline_us() <= Now_us)
+        {
+            Timeouts[i]->Sim_Fire();  // Removes itself from the list.
+            i = -1;                   // The callback may have re-armed or detached others: rescan.
+        }
+    }
+}
+
+static uint64_t Next_Event_us()  // Earliest pending device event or timeout. 0 when nothing is scheduled.
+{
+    uint64_t Next = 0;
+
+    for (int i = 0; i < Device_Count; i++)
+    {
+        uint64_t Event = Devices[i]->Sim_Next_Event_us();
+
+        if ((Event != 0) && ((Next == 0) || (Event < Next)))
+        {
+            Next = Event;
+        }
+    }
+
+    for (int i = 0; i < Timeout_Count; i++)
+    {
+        uint64_t Event = Timeouts[i]->Sim_Deadline_us();
+
+        if ((Next == 0) || (Event < Next))
+        {
+            Next = Event;
+        }
+    }
+
+    return Next;
+}
+
+void Sim_Advance_us(uint64_t Delta)  // Events are delivered in time order even when the step spans several of them.
+{
+    uint64_t Target = Now_us + Delta;
+
+    while (true)
+    {
+        uint64_t Next = Next_Event_us();
+
+        if ((Next == 0) || (Next > Target))
+        {
+            break;
+        }
+
+        if (Next > Now_us)
+        {
+            Now_us = Next;
+        }
+
+        Process_Devices();
+    }
+
+    Now_us = Target;
+    Process_Devices();
+}
+
+uint32_t us_ticker_read()
+{
+    return (uint32_t)Now_us;
+}
+
+void wait(float s)
+{
+    Sim_Advance_us((uint64_t)(s * 1000000.0f));
+}
+
+void wait_ms(int ms)
+{
+    Sim_Advance_us((uint64_t)ms * 1000);
+}
+
+void wait_us(int us)
+{
+    Sim_Advance_us((uint64_t)us);
+}
+
+void __WFI()
+{
+    uint64_t Next = Next_Event_us();
+
+    if ((Next == 0) || (Next <= Now_us))
+    {
+        Sim_Advance_us(1000);  // Nothing scheduled: the core would be woken by some other interrupt eventually.
+    }
+
+    else
+    {
+        Sim_Advance_us(Next - Now_us);
+    }
+}
+
+void sleep()
+{
+    __WFI();
+}
+
+void deepsleep()
+{
+    __WFI();
+}
+
+void __disable_irq()
+{
+}
+
+void __enable_irq()
+{
+}
+
+//=== Bus accounting ===
+
+void Sim_Bus_Reset()
+{
+    memset(&Sim_Bus, 0, sizeof(Sim_Bus));
+}
+
+//=== InterruptIn ===
+
+InterruptIn::InterruptIn(PinName pin) : Pin(pin), Level(1)
+{
+    if (Pin_Count < SIM_MAX_PINS)
+    {
+        Pins[Pin_Count++] = this;
+    }
+}
+
+InterruptIn::~InterruptIn()
+{
+    for (int i = 0; i < Pin_Count; i++)
+    {
+        if (Pins[i] == this)
+        {
+            Pins[i] = Pins[--Pin_Count];
+            break;
+        }
+    }
+}
+
+void InterruptIn::Sim_Drive(int New_Level)
+{
+    if (New_Level == Level)
+    {
+        return;
+    }
+
+    Level = New_Level;
+
+    if ((Level != 0) && Rise)
+    {
+        Rise();
+    }
+
+    if ((Level == 0) && Fall)
+    {
+        Fall();
+    }
+}
+
+InterruptIn *InterruptIn::Sim_Find(PinName pin)
+{
+    for (int i = 0; i < Pin_Count; i++)
+    {
+        if (Pins[i]->Pin == pin)
+        {
+            return Pins[i];
+        }
+    }
+
+    return NULL;
+}
+
+//=== Timeout ===
+
+void Timeout::attach_us(Callback<void()> func, uint32_t t)
+{
+    detach();
+
+    Func = func;
+    Deadline_us = Now_us + t;
+    Armed = true;
+
+    if (Timeout_Count < SIM_MAX_TIMEOUTS)
+    {
+        Timeouts[Timeout_Count++] = this;
+    }
+}
+
+void Timeout::detach()
+{
+    if (!Armed)
+    {
+        return;
+    }
+
+    Armed = false;
+
+    for (int i = 0; i < Timeout_Count; i++)
+    {
+        if (Timeouts[i] == this)
+        {
+            Timeouts[i] = Timeouts[--Timeout_Count];
+            break;
+        }
+    }
+}
+
+void Timeout::Sim_Fire()
+{
+    detach();
+
+    if (Func)
+    {
+        Func();
+    }
+}
+
+//=== I2C ===
+
+void Sim_Attach(PinName sda, Sim_I2C_Device *Device)
+{
+    if (Device_Count < SIM_MAX_DEVICES)
+    {
+        Device_Sda[Device_Count] = sda;
+        Devices[Device_Count] = Device;
+        Device_Count++;
+    }
+}
+
+static Sim_I2C_Device *Find_Device(PinName sda, int address)
+{
+    for (int i = 0; i < Device_Count; i++)
+    {
+        if ((Device_Sda[i] == sda) && (Devices[i]->Sim_Address() == (address & 0xFE)))
+        {
+            return Devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+I2C::I2C(PinName sda, PinName scl) : Sda(sda), Hz(100000), Transfer_Busy(false)
+{
+    (void)scl;
+}
+
+uint64_t I2C::Account(int Payload_Bytes, bool Acked)  // START + (address + payload) x 9 bits + STOP / repeated START.
+{
+    uint32_t Bits = 2 + (uint32_t)(1 + Payload_Bytes) * 9;
+    uint64_t Time_us = ((uint64_t)Bits * 1000000 + Hz - 1) / Hz;
+
+    Sim_Bus.Transactions++;
+    Sim_Bus.Bytes += 1 + Payload_Bytes;
+    Sim_Bus.Bus_Time_us += Time_us;
+
+    if (!Acked)
+    {
+        Sim_Bus.Nacks++;
+    }
+
+    return Time_us;
+}
+
+int I2C::write(int address, const char *data, int length, bool repeated)
+{
+    (void)repeated;
+    Sim_I2C_Device *Device = Find_Device(Sda, address);
+
+    if (Device == NULL)
+    {
+        Sim_Advance_us(Account(0, false));
+        return 1;
+    }
+
+    Device->Sim_Process();
+    Device->Sim_Write(data, length);
+    Sim_Advance_us(Account(length, true));
+
+    return 0;
+}
+
+int I2C::read(int address, char *data, int length, bool repeated)
+{
+    (void)repeated;
+    Sim_I2C_Device *Device = Find_Device(Sda, address);
+
+    if (Device == NULL)
+    {
+        Sim_Advance_us(Account(0, false));
+        return 1;
+    }
+
+    Device->Sim_Process();
+    Device->Sim_Read(data, length);
+    Sim_Advance_us(Account(length, true));
+
+    return 0;
+}
+
+int I2C::transfer(int address, const char *tx_buffer, int tx_length, void *rx_buffer, int rx_length, const event_callback_t &callback, int event, bool repeated)
+{
+    (void)repeated;
+
+    if (Transfer_Busy)
+    {
+        return -1;
+    }
+
+    bool Acked = (Find_Device(Sda, address) != NULL);
+    uint64_t Time_us = Account(Acked ? tx_length : 0, Acked);   // A missing device NACKs its address: no read phase.
+
+    if (Acked && (rx_length != 0))
+    {
+        Time_us += Account(rx_length, true);
+    }
+
+    Transfer_Busy = true;
+    Transfer_Address = address;
+    Transfer_Tx = tx_buffer;
+    Transfer_Tx_Length = tx_length;
+    Transfer_Rx = (char *)rx_buffer;
+    Transfer_Rx_Length = rx_length;
+    Transfer_Callback = callback;
+    Transfer_Event = event;
+
+    Transfer_Timer.attach_us(this, &I2C::Transfer_Done, (uint32_t)Time_us);
+
+    return 0;
+}
+
+void I2C::Transfer_Done()  // End of the bus time: move the data, then report.
+{
+    Sim_I2C_Device *Device = Find_Device(Sda, Transfer_Address);
+    int Event = I2C_EVENT_ERROR_NO_SLAVE;
+
+    if (Device != NULL)
+    {
+        Device->Sim_Process();
+        Device->Sim_Write(Transfer_Tx, Transfer_Tx_Length);
+
+        if (Transfer_Rx_Length != 0)
+        {
+            Device->Sim_Read(Transfer_Rx, Transfer_Rx_Length);
+        }
+
+        Event = I2C_EVENT_TRANSFER_COMPLETE;
+    }
+
+    Transfer_Busy = false;   // Released before the callback so that it may start the next transfer.
+
+    if (((Event & Transfer_Event) != 0) && Transfer_Callback)
+    {
+        Transfer_Callback(Event);
+    }
+}
@@ -21,9 +21,13 @@ int main()
      
      char ink = MPL.MPL_Who_Am_I_();
      
-     double my_pressude  = MPL.MPL_Get_Pressure();
+     MPL_Sample my_sample;
      
-     double my_temper = MPL.MPL_Get_Temperature();
+     MPL.MPL_Read_Sample(my_sample);   // One acquisition for both Pressure and Temperature
+     
+     double my_pressude  = my_sample.Pressure;
+     
+     double my_temper = my_sample.Temperature;
      
      wait_ms(300);
 